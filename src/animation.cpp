@@ -69,32 +69,292 @@ JerkMotion::JerkMotion(float jerk,
 }
 
 
-ReelMotion::ReelMotion(float reel_length)
-  : m_length(reel_length)
-  , m_min_speed_proxy(0.f)
+Trajectory::Trajectory(JerkMotion start) noexcept
+{
+  m_segments[0] = start;
+}
+
+uint8_t Trajectory::find_segment(float time) const noexcept
+{
+  uint8_t i = m_nsegments - 1;
+  while (i > 0 && time < m_begins[i]) {
+    --i;
+  }
+  return i;
+}
+
+JerkMotion Trajectory::evaluate(float time) const noexcept
+{
+  uint8_t i = find_segment(time);
+  JerkMotion state = m_segments[i];
+  state.advance(std::max(time - m_begins[i], 0.f));
+  return state;
+}
+
+void Trajectory::split(float time,
+                       float speed,
+                       float acceleration,
+                       float jerk) noexcept
+{
+  assert(time >= get_last_begin());
+  float position = evaluate(time).get_position();
+
+  if (time > get_last_begin()) {
+    assert(m_nsegments < max_segments);
+    m_begins[m_nsegments] = time;
+    m_nsegments += 1;
+  }
+  m_segments[m_nsegments - 1] =
+    JerkMotion{ jerk, acceleration, speed, position };
+}
+
+void Trajectory::stop(float time, float position) noexcept
+{
+  split(time, 0.f);
+  m_segments[m_nsegments - 1].set_positon(position);
+}
+
+bool Trajectory::ends_with_rest() const noexcept
+{
+  const JerkMotion& last = m_segments[m_nsegments - 1];
+  return last.get_speed() == 0.f && last.get_acceleration() == 0.f &&
+         last.get_jerk() == 0.f;
+}
+
+
+ReelBank::ReelId ReelBank::add(float reel_length)
 {
   assert(reel_length > 0.f);
+  ReelId id = size();
+
+  m_trajectories.emplace_back();
+  m_times.push_back(0.f);
+  m_seg_begins.push_back(0.f);
+  m_seg_ends.push_back(std::numeric_limits<float>::infinity());
+  m_seg_positions.push_back(0.f);
+  m_seg_speeds.push_back(0.f);
+  m_seg_accelerations.push_back(0.f);
+  m_seg_jerks.push_back(0.f);
+  m_positions.push_back(0.f);
+  m_prev_positions.push_back(0.f);
+  m_render_positions.push_back(0.f);
+  m_lengths.push_back(reel_length);
+  m_min_speeds.push_back(0.f);
+  m_max_speeds.push_back(0.f);
+  m_moving.push_back(0);
+  m_rest_handlers.emplace_back();
+  return id;
 }
 
-void ReelMotion::set_reel_length(float length) noexcept
+void ReelBank::reserve(uint32_t n)
 {
-  assert(length > 0.f);
-  m_length = length;
-  if (get_position() >= m_length) {
-    float rotations_made = std::floor(get_position() / m_length);
-    set_positon(get_position() - rotations_made * m_length);
+  m_trajectories.reserve(n);
+  for (std::vector<float>* v :
+       { &m_times, &m_seg_begins, &m_seg_ends, &m_seg_positions,
+         &m_seg_speeds, &m_seg_accelerations, &m_seg_jerks, &m_positions,
+         &m_prev_positions, &m_render_positions, &m_lengths, &m_min_speeds,
+         &m_max_speeds }) {
+    v->reserve(n);
   }
+  m_moving.reserve(n);
+  m_rest_handlers.reserve(n);
+}
+
+void ReelBank::advance(float dt)
+{
+  if (m_nmoving == 0) {
+    if (!m_settled) { // last move has nothing to interpolate from now
+      m_prev_positions = m_render_positions = m_positions;
+      m_settled = true;
+    }
+    return;
+  }
+  m_settled = false;
+
+  const ReelId n = size();
+  for (ReelId i = 0; i < n; ++i) {
+    m_times[i] += dt;
+    if (m_times[i] >= m_seg_ends[i]) { // rare, few times per trajectory
+      load_segment(i);
+      if (m_moving[i] && is_at_rest(i)) {
+        m_moving[i] = 0;
+        m_nmoving -= 1;
+        m_came_to_rest.push_back(i);
+      }
+    } else if (m_times[i] - m_seg_begins[i] >= max_segment_time) {
+      rebase(i);
+    }
+  }
+  m_prev_positions = m_positions;
+  update_state(0, n);
+  m_render_positions = m_positions;
+
+  // Handlers may start reels again, but not advance the bank
+  for (ReelId id : m_came_to_rest) {
+    if (m_rest_handlers[id]) {
+      m_rest_handlers[id]();
+    }
+  }
+  m_came_to_rest.clear();
+}
+
+void ReelBank::interpolate(float alpha) noexcept
+{
+  if (m_settled) {
+    return;
+  }
+  const ReelId n = size();
+  const float* prev = m_prev_positions.data();
+  const float* cur = m_positions.data();
+  const float* lengths = m_lengths.data();
+  float* render = m_render_positions.data();
+
+  for (ReelId i = 0; i < n; ++i) {
+    const float l = lengths[i];
+    float path = cur[i] - prev[i];
+    // Shortest way around the reel. Reels move forward much less than half
+    // a reel per step, small backward steps come from rounding of the rest
+    // position
+    path += path < -0.5f * l ? l : path > 0.5f * l ? -l : 0.f;
+    float p = prev[i] + path * alpha;
+    p += p < 0.f ? l : 0.f;
+    render[i] = p >= l ? p - l : p;
+  }
+}
+
+void ReelBank::update_state(ReelId first, ReelId last) noexcept
+{
+  const float* times = m_times.data();
+  const float* begins = m_seg_begins.data();
+  const float* s0 = m_seg_positions.data();
+  const float* v0 = m_seg_speeds.data();
+  const float* a0 = m_seg_accelerations.data();
+  const float* jerks = m_seg_jerks.data();
+  const float* lengths = m_lengths.data();
+  float* positions = m_positions.data();
+
+  // Same law as Motion::advance. Only position is needed every frame, other
+  // components are computed on demand. The polynomial is a few multiply-adds
+  // and vectorizes, a sampled curve table would gather instead
+  for (ReelId i = first; i < last; ++i) {
+    const float t = times[i] - begins[i];
+    const float j = jerks[i];
+    const float a = a0[i];
+    const float v = v0[i];
+    const float s = s0[i] + (v + (a / 2.f + j * t / 6.f) * t) * t;
+
+    // Reels don't move backwards, so truncation works as floor here and
+    // unlike std::floor it vectorizes without SSE4.1
+    const float l = lengths[i];
+    const float rotations = static_cast<float>(static_cast<int32_t>(s / l));
+    positions[i] = s - rotations * l;
+  }
+}
+
+void ReelBank::load_segment(ReelId id) noexcept
+{
+  const Trajectory& tr = m_trajectories[id];
+  uint8_t seg = tr.find_segment(m_times[id]);
+  const JerkMotion& law = tr.get_segment(seg);
+
+  m_seg_begins[id] = tr.get_begin(seg);
+  m_seg_ends[id] = tr.get_end(seg);
+  m_seg_positions[id] = law.get_position();
+  m_seg_speeds[id] = law.get_speed();
+  m_seg_accelerations[id] = law.get_acceleration();
+  m_seg_jerks[id] = law.get_jerk();
+}
+
+void ReelBank::rebase(ReelId id) noexcept
+{
+  // Only the last segment is endless. Rest and uniform motion continue
+  // from wrapped position the same way
+  JerkMotion state = m_trajectories[id].evaluate(m_times[id]);
+  state.set_positon(std::fmod(state.get_position(), m_lengths[id]));
+  m_trajectories[id] = Trajectory(state);
+  m_times[id] = 0.f;
+  load_segment(id);
+}
+
+void ReelBank::set_trajectory(ReelId id, const Trajectory& trajectory) noexcept
+{
+  m_trajectories[id] = trajectory;
+  seek(id, 0.f);
+}
+
+void ReelBank::seek(ReelId id, float time) noexcept
+{
+  m_times[id] = time;
+  load_segment(id);
+  update_state(id, id + 1);
+  // Jump, nothing to interpolate
+  m_prev_positions[id] = m_render_positions[id] = m_positions[id];
+  update_moving(id);
+}
+
+void ReelBank::update_moving(ReelId id) noexcept
+{
+  const uint8_t moving = is_at_rest(id) ? 0 : 1;
+  m_nmoving = m_nmoving - m_moving[id] + moving;
+  m_moving[id] = moving;
+}
+
+void ReelBank::set_rest_handler(ReelId id, RestHandler handler)
+{
+  m_rest_handlers[id] = std::move(handler);
+}
+
+bool ReelBank::is_at_rest(ReelId id) const noexcept
+{
+  const Trajectory& tr = m_trajectories[id];
+  return tr.ends_with_rest() && m_times[id] >= tr.get_last_begin();
+}
+
+JerkMotion ReelBank::get_state(ReelId id) const noexcept
+{
+  const float t = m_times[id] - m_seg_begins[id];
+  const float j = m_seg_jerks[id];
+  const float a = m_seg_accelerations[id];
+  const float v = m_seg_speeds[id];
+  return JerkMotion{
+    j, a + j * t, v + (a + j * t / 2.f) * t, m_positions[id]
+  };
+}
+
+void ReelBank::set_reel_length(ReelId id, float length) noexcept
+{
+  assert(length > 0.f);
+  m_lengths[id] = length;
+  update_state(id, id + 1);
+  m_prev_positions[id] = m_render_positions[id] = m_positions[id];
+}
+
+void ReelBank::set_min_speed(ReelId id, float speed) noexcept
+{
+  m_min_speeds[id] = speed;
+}
+
+void ReelBank::set_max_speed(ReelId id, float speed) noexcept
+{
+  m_max_speeds[id] = speed;
+}
+
+
+ReelMotion::ReelMotion(ReelBank& bank, float reel_length)
+  : m_bank(&bank)
+  , m_id(bank.add(reel_length))
+{
 }
 
 void ReelMotion::stop_in(float end_position, float t)
 {
   assert(t != 0.f);
-  assert(end_position <= m_length);
+  assert(end_position <= get_reel_length());
 
   const float v = get_speed();
   const float s0 = get_position();
   const float s1 = end_position;
-  const float l = m_length;
+  const float l = get_reel_length();
 
   float k; // minimum rotations required, so that speed doesn't go negative
   float a; // acceleration
@@ -121,79 +381,36 @@ void ReelMotion::stop_in(float end_position, float t)
   j = 12.f * (s0 - s1 - k * l + v * t / 2.f) / (t * t * t);
   a = -v / t - j * t / 2;
 
-  set_jerk(j);
-  set_acceleration(a);
-
-  m_min_speed = 0.f;
-  m_max_speed = float_limits::infinity();
-  m_state = State::had_impact;
+  Trajectory tr(JerkMotion{ j, a, v, s0 });
+  // Exact end position, no rounding error accumulation
+  tr.stop(t, end_position);
+  m_bank->set_trajectory(m_id, tr);
 }
 
 void ReelMotion::go_full_speed_in(float time)
 {
-  m_max_speed = m_max_speed_proxy;
-  AcceleratedMotion accm{ get_acceleration(), get_speed(), get_position() };
-  float new_acc = accm.nccry_acc_to_speed(m_max_speed, time);
-  set_acceleration(new_acc);
-  m_state = State::had_impact;
-}
+  JerkMotion state = m_bank->get_state(m_id);
+  AcceleratedMotion accm{ state.get_acceleration(),
+                          state.get_speed(),
+                          state.get_position() };
+  float new_acc = accm.nccry_acc_to_speed(get_max_speed(), time);
 
-void ReelMotion::slow_to_minimal_in(float time)
-{
-  m_min_speed = m_min_speed_proxy;
-  AcceleratedMotion accm{ get_acceleration(), get_speed(), get_position() };
-  float new_acc = accm.nccry_acc_to_speed(m_min_speed, time);
-  set_acceleration(new_acc);
+  Trajectory tr(
+    JerkMotion{ 0.f, new_acc, state.get_speed(), state.get_position() });
+  tr.split(time, get_max_speed());
+  m_bank->set_trajectory(m_id, tr);
 }
 
-void ReelMotion::set_min_speed(float speed)
-{
-  m_min_speed_proxy = speed;
-}
-
-void ReelMotion::set_max_speed(float speed)
+void ReelMotion::slow_to_minimal_in(float time)
 {
-  m_max_speed_proxy = speed;
-}
+  JerkMotion state = m_bank->get_state(m_id);
+  AcceleratedMotion accm{ state.get_acceleration(),
+                          state.get_speed(),
+                          state.get_position() };
+  float new_acc = accm.nccry_acc_to_speed(get_min_speed(), time);
 
-void ReelMotion::advance(float dt)
-{
-  if (dt == 0.f) {
-    return;
-  }
-  switch (m_state) {
-    case State::had_impact:
-      SpeedLimitedMotion::advance(dt);
-      m_state = State::moving;
-      break;
-    case State::moving: {
-      float stop_time = time_to_speed(0.f);
-      if (stop_time <= dt) {
-        SpeedLimitedMotion::advance(stop_time);
-        full_stop();
-
-      } else {
-        SpeedLimitedMotion::advance(dt);
-        if (get_max_speed() <= 0.f) { // ? may be rounding error
-          full_stop();
-        }
-      }
-      break;
-    }
-    default:
-      break;
-  }
-
-  float rotations_made = std::floor(get_position() / m_length);
-  set_positon(get_position() - rotations_made * m_length);
-}
-
-void ReelMotion::full_stop()
-{
-  set_speed(0.f);
-  set_acceleration(0.f);
-  set_jerk(0.f);
-  set_positon(
-    std::round(get_position())); // prevent rounding error accumulation
-  m_state = State::rest;
+  Trajectory tr(
+    JerkMotion{ 0.f, new_acc, state.get_speed(), state.get_position() });
+  tr.split(time, get_min_speed());
+  m_bank->set_trajectory(m_id, tr);
 }
@@ -7,7 +7,9 @@
 #include <array>
 #include <cmath>
 #include <cstdint>
+#include <functional>
 #include <limits>
+#include <vector>
 
 std::pair<float, float> quad_equation(float a, float b, float c);
 
@@ -27,11 +29,14 @@ constexpr bool operator>=(MotionType lhs, MotionType rhs)
 }
 
 
-template<MotionType MT>
+// Precision of motion components is selected with T: float, double or
+// Fixed32. Time arguments are float regardless
+template<MotionType MT, class T = float>
 class Motion
 {
 public:
   using float_limits = std::numeric_limits<float>;
+  using Scalar = T;
 
   enum class MotionComponent : uint8_t
   {
@@ -49,34 +54,35 @@ public:
   static constexpr uint8_t n_components = static_cast<uint8_t>(MT) + 1;
   struct ComponentArray
   {
-    const float& operator[](MotionComponent t) const noexcept
+    const T& operator[](MotionComponent t) const noexcept
     {
       return data[static_cast<uint8_t>(t)];
     }
-    float& operator[](MotionComponent t) noexcept
+    T& operator[](MotionComponent t) noexcept
     {
       return data[static_cast<uint8_t>(t)];
     }
 
-    std::array<float, n_components> data;
+    std::array<T, n_components> data;
   };
 
-  Motion(std::array<float, n_components> cmp) noexcept
+  Motion(std::array<T, n_components> cmp) noexcept
   {
     for (uint8_t i = 0; i < n_components; ++i) {
       components.data[i] = cmp[i];
     }
   }
 
-  void advance(float dt) noexcept
+  void advance(float time) noexcept
   {
-    const float j = get_jerk();
-    const float a = get_acceleration();
-    const float v = get_speed();
-    const float s = get_position();
-
-    set_positon(s + (v + (a / 2.f + j * dt / 6.f) * dt) * dt);
-    set_speed(v + (a + j * dt / 2.f) * dt);
+    const T dt = time;
+    const T j = get_jerk();
+    const T a = get_acceleration();
+    const T v = get_speed();
+    const T s = get_position();
+
+    set_positon(s + (v + (a / T(2.f) + j * dt / T(6.f)) * dt) * dt);
+    set_speed(v + (a + j * dt / T(2.f)) * dt);
     set_acceleration(a + j * dt);
   }
 
@@ -87,9 +93,9 @@ public:
       *second_res = float_limits::infinity();
     }
 
-    const float j = get_jerk();
-    const float a = get_acceleration();
-    const float v0 = get_speed();
+    const float j = static_cast<float>(get_jerk());
+    const float a = static_cast<float>(get_acceleration());
+    const float v0 = static_cast<float>(get_speed());
 
     if constexpr (MT == MotionType::stationary) {
       return v1 == 0.f ? 0.f : float_limits::infinity();
@@ -131,48 +137,48 @@ public:
     }
   }
 
-  float get_position() const noexcept { return components[pos]; }
-  void set_positon(float p) noexcept { components[pos] = p; }
+  T get_position() const noexcept { return components[pos]; }
+  void set_positon(T p) noexcept { components[pos] = p; }
 
-  float get_speed() const noexcept
+  T get_speed() const noexcept
   {
     if constexpr (MT >= MotionType::uniform) {
       return components[spd];
     }
-    return 0.f;
+    return T{};
   }
 
-  void set_speed(float s) noexcept
+  void set_speed(T s) noexcept
   {
     if constexpr (MT >= MotionType::uniform) {
       components[spd] = s;
     }
   }
 
-  float get_acceleration() const noexcept
+  T get_acceleration() const noexcept
   {
     if constexpr (MT >= MotionType::accelerated) {
       return components[acc];
     }
-    return 0.f;
+    return T{};
   }
 
-  void set_acceleration(float a) noexcept
+  void set_acceleration(T a) noexcept
   {
     if constexpr (MT >= MotionType::accelerated) {
       components[acc] = a;
     }
   }
 
-  float get_jerk() const noexcept
+  T get_jerk() const noexcept
   {
     if constexpr (MT >= MotionType::jerked) {
       return components[jrk];
     }
-    return 0.f;
+    return T{};
   }
 
-  void set_jerk(float j) noexcept
+  void set_jerk(T j) noexcept
   {
     if constexpr (MT >= MotionType::jerked) {
       components[jrk] = j;
@@ -237,143 +243,173 @@ public:
 };
 
 
-template<MotionType MT>
-class SpeedLimitedMotion : public Motion<MT>
+// Piecewise jerk motion law. Segments follow each other without gaps, the
+// last one lasts forever. State at any time is computed directly from the
+// segment polynomial, so frames don't accumulate error
+class Trajectory
 {
-  static_assert(MT >= MotionType::accelerated);
-
 public:
-  using float_limits = std::numeric_limits<float>;
+  static constexpr uint8_t max_segments = 4;
 
-  SpeedLimitedMotion(
-    float min_speed = 0.f,
-    float max_speed = 0.f,
-    std::array<float, Motion<MT>::n_components> cmps = {}) noexcept
-    : Motion<MT>(cmps)
-    , m_min_speed(min_speed)
-    , m_max_speed(max_speed)
+  Trajectory(JerkMotion start = {}) noexcept;
+  JerkMotion evaluate(float time) const noexcept;
+  // Last segment ends at time, new one continues from reached position
+  void split(float time,
+             float speed,
+             float acceleration = 0.f,
+             float jerk = 0.f) noexcept;
+  // Last segment ends at time, then rest at position
+  void stop(float time, float position) noexcept;
+  float get_last_begin() const noexcept { return m_begins[m_nsegments - 1]; }
+  bool ends_with_rest() const noexcept;
+
+  uint8_t find_segment(float time) const noexcept;
+  uint8_t get_n_segments() const noexcept { return m_nsegments; }
+  float get_begin(uint8_t i) const noexcept { return m_begins[i]; }
+  // Infinity for the last segment
+  float get_end(uint8_t i) const noexcept
   {
+    return i + 1 < m_nsegments ? m_begins[i + 1]
+                               : std::numeric_limits<float>::infinity();
   }
-
-  bool limit_reached() const noexcept
+  const JerkMotion& get_segment(uint8_t i) const noexcept
   {
-    return this->get_speed() <= m_min_speed || this->get_speed() >= m_max_speed;
+    return m_segments[i];
   }
 
-  // Keeps speed the same
-  void uniform_advance(float dt) noexcept
+private:
+  std::array<float, max_segments> m_begins{};
+  std::array<JerkMotion, max_segments> m_segments{};
+  uint8_t m_nsegments{ 1 };
+};
+
+
+// Motion state of many reels in structure of arrays layout. Every frame all
+// reels are advanced in one branch free pass over the arrays. Nothing is
+// done while all reels are at rest
+class ReelBank
+{
+public:
+  using ReelId = uint32_t;
+  using RestHandler = std::function<void()>;
+
+  // Open ended last segment is restarted from current state after this
+  // time, so reel clock and travelled path stay small in float
+  static constexpr float max_segment_time = 60.f;
+
+  ReelId add(float reel_length);
+  uint32_t size() const noexcept { return m_lengths.size(); }
+  void reserve(uint32_t n);
+  // Rest handlers of reels stopped during this step are called at the end
+  void advance(float dt);
+  // Positions between previous and current advance, alpha in [0, 1]
+  void interpolate(float alpha) noexcept;
+  // Reel starts trajectory from its zero time
+  void set_trajectory(ReelId id, const Trajectory& trajectory) noexcept;
+  // Moves reel to time passed since trajectory start
+  void seek(ReelId id, float time) noexcept;
+  bool is_at_rest(ReelId id) const noexcept;
+  // All reels are at rest
+  bool is_at_rest() const noexcept { return m_nmoving == 0; }
+  // Called when reel comes to rest by advance
+  void set_rest_handler(ReelId id, RestHandler handler);
+
+  JerkMotion get_state(ReelId id) const noexcept;
+  float get_position(ReelId id) const noexcept { return m_positions[id]; }
+  float get_render_position(ReelId id) const noexcept
   {
-    this->set_positon(this->get_position() + this->get_speed() * dt);
-    this->set_acceleration(this->get_acceleration() + this->get_jerk() * dt);
+    return m_render_positions[id];
   }
-
-  void advance(float dt)
+  float get_speed(ReelId id) const noexcept
   {
-    struct ExtremumHit
-    {
-      float time;
-      float value;
-      bool operator<(const ExtremumHit& other) const
-      {
-        return time < other.time;
-      }
-    };
-
-    // In jerk motion speed changes according to quadratic law (parabola graph)
-    // While moving we can hit minimum and maximum values up to twice each
-    float time_to_max2 = float_limits::infinity();
-    float time_to_max1 = this->time_to_speed(m_max_speed, &time_to_max2);
-    float time_to_min2 = float_limits::infinity();
-    float time_to_min1 = this->time_to_speed(m_min_speed, &time_to_min2);
-
-    std::array extremums = { ExtremumHit{ time_to_max1, m_max_speed },
-                             ExtremumHit{ time_to_max2, m_max_speed },
-                             ExtremumHit{ time_to_min1, m_min_speed },
-                             ExtremumHit{ time_to_min2, m_min_speed } };
-    std::sort(extremums.begin(), extremums.end());
-
-    float prev_t = 0.f;
-    for (int i = 0; i < extremums.size() && !std::isinf(extremums[i].time);
-         ++i) {
-      bool is_time_up = dt <= extremums[i].time;
-      float t_spent = (is_time_up ? dt : extremums[i].time) - prev_t;
-
-      bool is_exceeded;
-      bool naturaly_limited;
-      if (extremums[i].value == m_max_speed) {
-        is_exceeded = this->get_speed() >= m_max_speed;
-        naturaly_limited = this->get_jerk() > 0.f; // Finite parabola bottom
-      } else {
-        is_exceeded = this->get_speed() <= m_min_speed;
-        naturaly_limited = this->get_jerk() < 0.f; // Finite parabola top
-      }
-      // If currently at the top/bottom part of the parabola
-      bool is_prev_same = i > 0 && extremums[i - 1].value == extremums[i].value;
-      // Traversing top/bottom of parabola that under our limit
-      bool will_reduce = is_prev_same && naturaly_limited;
-
-      if (is_exceeded && !will_reduce) {
-        uniform_advance(t_spent);
-      } else {
-        Motion<MT>::advance(t_spent);
-        if (!is_time_up) {                     // reached extremum
-          this->set_speed(extremums[i].value); // ensure no rounding error
-        }
-      }
-
-      if (is_time_up) {
-        prev_t = dt;
-        break;
-      }
-      prev_t = extremums[i].time;
-    }
-    if (prev_t < dt) { // right branch of the parabola
-      uniform_advance(dt - prev_t);
-    }
+    return get_state(id).get_speed();
   }
+  float get_reel_length(ReelId id) const noexcept { return m_lengths[id]; }
+  void set_reel_length(ReelId id, float length) noexcept;
+  float get_min_speed(ReelId id) const noexcept { return m_min_speeds[id]; }
+  void set_min_speed(ReelId id, float speed) noexcept;
+  float get_max_speed(ReelId id) const noexcept { return m_max_speeds[id]; }
+  void set_max_speed(ReelId id, float speed) noexcept;
 
-  float get_max_speed() const noexcept { return m_max_speed; }
-  void set_max_speed(float speed) noexcept { m_max_speed = speed; }
-  float get_min_speed() const noexcept { return m_min_speed; }
-  void set_min_speed(float speed) noexcept { m_min_speed = speed; }
-
-protected:
-  float m_max_speed;
-  float m_min_speed;
+private:
+  // Copy segment active at current reel time
+  void load_segment(ReelId id) noexcept;
+  void rebase(ReelId id) noexcept;
+  void update_moving(ReelId id) noexcept;
+  void update_state(ReelId first, ReelId last) noexcept;
+
+  std::vector<Trajectory> m_trajectories;
+  std::vector<float> m_times; // since trajectory start
+  // Active segment bounds and motion law
+  std::vector<float> m_seg_begins;
+  std::vector<float> m_seg_ends;
+  std::vector<float> m_seg_positions;
+  std::vector<float> m_seg_speeds;
+  std::vector<float> m_seg_accelerations;
+  std::vector<float> m_seg_jerks;
+  // Position at current time, wrapped by reel length
+  std::vector<float> m_positions;
+  std::vector<float> m_prev_positions;
+  std::vector<float> m_render_positions;
+  std::vector<float> m_lengths;
+  // User preffered speed limits
+  std::vector<float> m_min_speeds;
+  std::vector<float> m_max_speeds;
+
+  std::vector<uint8_t> m_moving;
+  uint32_t m_nmoving{ 0 };
+  bool m_settled{ true }; // interpolation is synced after last move
+  std::vector<RestHandler> m_rest_handlers;
+  std::vector<ReelId> m_came_to_rest; // during current advance
 };
 
 
-class ReelMotion : public SpeedLimitedMotion<MotionType::jerked>
+// Controls one reel of the bank
+class ReelMotion
 {
 public:
-  ReelMotion(float reel_length);
-  float get_reel_length() const noexcept { return m_length; }
-  void set_reel_length(float length) noexcept;
+  ReelMotion(ReelBank& bank, float reel_length);
+  float get_reel_length() const noexcept
+  {
+    return m_bank->get_reel_length(m_id);
+  }
+  void set_reel_length(float length) noexcept
+  {
+    m_bank->set_reel_length(m_id, length);
+  }
   // Will stop reel at specified time in specified position regardless min_speed
   // If starts from rest may exceed max speed limit to get to position in time
   void stop_in(float end_position, float time);
   void go_full_speed_in(float time);
   void slow_to_minimal_in(float time);
 
-  // Hide parent's definitions
-  void advance(float dt);
-  void set_min_speed(float speed);
-  void set_max_speed(float speed);
-
-private:
-  enum class State
+  // Moves to time passed since last stop_in/go_full_speed_in/slow_to_minimal_in
+  // or since reel clock was rebased
+  void seek(float time) noexcept { m_bank->seek(m_id, time); }
+  bool is_at_rest() const noexcept { return m_bank->is_at_rest(m_id); }
+  void set_rest_handler(ReelBank::RestHandler handler)
   {
-    rest = 0,
-    had_impact, // allow to move from rest state
-    moving,     // may stop any moment
-    number
-  };
-  void full_stop();
+    m_bank->set_rest_handler(m_id, std::move(handler));
+  }
+  float get_position() const noexcept { return m_bank->get_position(m_id); }
+  float get_render_position() const noexcept
+  {
+    return m_bank->get_render_position(m_id);
+  }
+  float get_speed() const noexcept { return m_bank->get_speed(m_id); }
+  float get_min_speed() const noexcept { return m_bank->get_min_speed(m_id); }
+  void set_min_speed(float speed) noexcept
+  {
+    m_bank->set_min_speed(m_id, speed);
+  }
+  float get_max_speed() const noexcept { return m_bank->get_max_speed(m_id); }
+  void set_max_speed(float speed) noexcept
+  {
+    m_bank->set_max_speed(m_id, speed);
+  }
 
-  State m_state{ State::rest };
-  float m_length;
-  // User preffered speed limits
-  float m_min_speed_proxy{ 0.f };
-  float m_max_speed_proxy{ 0.f };
+private:
+  ReelBank* m_bank;
+  ReelBank::ReelId m_id;
 };
 #endif
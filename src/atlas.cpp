@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#include "atlas.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+
+SkylinePacker::SkylinePacker(uint16_t page_size)
+  : m_page_size(page_size)
+{
+}
+
+SkylinePacker::Placement SkylinePacker::place(uint16_t w, uint16_t h)
+{
+  if (w > m_page_size || h > m_page_size) {
+    throw ThreadException(
+      "%ux%u doesn't fit %u atlas page", w, h, m_page_size);
+  }
+
+  for (uint32_t page = 0; page <= m_pages.size(); ++page) {
+    if (page == m_pages.size()) {
+      m_pages.push_back({ Segment{ 0, 0, m_page_size } });
+    }
+    Skyline& skyline = m_pages[page];
+
+    uint32_t best = skyline.size();
+    uint32_t best_y = m_page_size;
+    for (uint32_t i = 0; i < skyline.size(); ++i) {
+      const uint32_t y = fit(skyline, i, w);
+      if (y + h <= m_page_size && y < best_y) {
+        best = i;
+        best_y = y;
+      }
+    }
+    if (best != skyline.size()) {
+      const uint32_t x = skyline[best].x;
+      insert(skyline, best, w, best_y + h);
+      return { page,
+               static_cast<uint16_t>(x),
+               static_cast<uint16_t>(best_y) };
+    }
+  }
+  return {}; // unreachable, empty page always fits
+}
+
+uint32_t SkylinePacker::fit(const Skyline& skyline,
+                            uint32_t i,
+                            uint32_t w) const noexcept
+{
+  const uint32_t right = skyline[i].x + w;
+  if (right > m_page_size) {
+    return m_page_size;
+  }
+  // Rectangle rests on the highest segment under it
+  uint32_t y = 0;
+  for (; i < skyline.size() && skyline[i].x < right; ++i) {
+    y = std::max(y, skyline[i].y);
+  }
+  return y;
+}
+
+void SkylinePacker::insert(Skyline& skyline,
+                           uint32_t i,
+                           uint32_t w,
+                           uint32_t top)
+{
+  const uint32_t x = skyline[i].x;
+  const uint32_t right = x + w;
+
+  // Segments under rectangle are replaced, partly covered one is cut
+  uint32_t j = i;
+  while (j < skyline.size() && skyline[j].x + skyline[j].w <= right) {
+    ++j;
+  }
+  if (j < skyline.size() && skyline[j].x < right) {
+    skyline[j].w -= right - skyline[j].x;
+    skyline[j].x = right;
+  }
+  skyline.erase(skyline.begin() + i, skyline.begin() + j);
+  skyline.insert(skyline.begin() + i, Segment{ x, top, w });
+
+  // Neighbours of equal height become one segment
+  for (uint32_t k = 1; k < skyline.size();) {
+    if (skyline[k - 1].y == skyline[k].y) {
+      skyline[k - 1].w += skyline[k].w;
+      skyline.erase(skyline.begin() + k);
+    } else {
+      ++k;
+    }
+  }
+}
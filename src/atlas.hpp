@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#ifndef SLOT_MACHINE_ATLAS
+#define SLOT_MACHINE_ATLAS
+
+#include <cstdint>
+#include <vector>
+
+// Skyline bottom-left packer of rectangles into square pages. Every page
+// keeps top outline of placed rectangles, new one goes to the lowest spot
+// where it fits. New page is opened when no existing page has room
+class SkylinePacker
+{
+public:
+  struct Placement
+  {
+    uint32_t page;
+    uint16_t x;
+    uint16_t y;
+  };
+
+  explicit SkylinePacker(uint16_t page_size);
+  // Rectangles sorted by decreasing height pack tighter
+  Placement place(uint16_t w, uint16_t h);
+  uint32_t get_npages() const noexcept { return m_pages.size(); }
+
+private:
+  // Horizontal piece of outline
+  struct Segment
+  {
+    uint32_t x;
+    uint32_t y;
+    uint32_t w;
+  };
+  using Skyline = std::vector<Segment>;
+
+  // Lowest top of rectangle starting at segment i, page_size if it's out
+  uint32_t fit(const Skyline& skyline, uint32_t i, uint32_t w) const noexcept;
+  void insert(Skyline& skyline, uint32_t i, uint32_t w, uint32_t top);
+
+  uint32_t m_page_size;
+  std::vector<Skyline> m_pages;
+};
+#endif
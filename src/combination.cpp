@@ -3,49 +3,19 @@
 #include "combination.hpp"
 #include <algorithm>
 #include <cassert>
-#include <cmath>
 #include <cstdint>
 
 using Range = Combination::Range;
 using ContinuosRanges = Combination::ContinuosRanges;
 
-constexpr uint32_t Combination::get_symbol_base_value(Symbol s) noexcept
-{
-  switch (s) {
-    case Symbol::lucky_seven:
-      return 32;
-    case Symbol::cross:
-    case Symbol::respin:
-    case Symbol::question:
-      return 12;
-    case Symbol::apple:
-    case Symbol::carrot:
-    case Symbol::corn:
-    case Symbol::grape:
-      return 8;
-    case Symbol::spade:
-    case Symbol::club:
-    case Symbol::heart:
-    case Symbol::diamond:
-      return 16;
-    case Symbol::amethyst:
-    case Symbol::emerald:
-    case Symbol::topaz:
-    case Symbol::crystal:
-      return 24;
-    case Symbol::number:
-      return 0;
-  }
-}
-
-
-Range Combination::get_max_equal_range(uint32_t* data, uint32_t size)
+template<class T>
+Range Combination::get_max_equal_range(const T* data, uint32_t size)
 {
   assert(size != 0);
 
   Range cur{ 0, 1 };
   Range maximal = cur;
-  uint32_t prev_val = data[0];
+  T prev_val = data[0];
 
   for (uint32_t i = 1; i < size; ++i) {
     if (data[i] == prev_val) {
@@ -67,7 +37,8 @@ bool operator==(const Range& lhs, const Range& rhs) noexcept
   return lhs.begin == rhs.begin && lhs.size == rhs.size;
 }
 
-ContinuosRanges Combination::get_ranges(uint32_t* data, uint32_t size)
+template<class T>
+ContinuosRanges Combination::get_ranges(const T* data, uint32_t size)
 {
   assert(size != 0);
 
@@ -111,7 +82,7 @@ ContinuosRanges Combination::get_ranges(uint32_t* data, uint32_t size)
 
 Combination::Combination(SymbolRow row)
   : m_row(row)
-  , m_ranges(get_ranges(reinterpret_cast<uint32_t*>(row.data()), row.size()))
+  , m_ranges(get_ranges(row.data(), row.size()))
 {
 }
 
@@ -139,28 +110,30 @@ void Combination::apply_questions()
   }
 
   // Expand m_ranges to left or right side
-  for (uint32_t i = 0; i < m_ranges.size(); ++i) {
+  for (uint32_t i = 0; i < m_ranges.size();) {
     Symbol s = m_row[m_ranges[i].begin];
-    if (s == Symbol::question) {
-      Range dummy{ 0, 0 };
-      // Biggest near range
-      Range& max_range = i == 0                     ? m_ranges[i + 1]
-                         : i == m_ranges.size() - 1 ? m_ranges[i - 1]
-                         : m_ranges[i - 1].size < m_ranges[i + 1].size
-                           ? m_ranges[i + 1]
-                           : m_ranges[i - 1].size > m_ranges[i + 1].size
-                           ? m_ranges[i - 1]
-                           : dummy; // if ranges are equal don't apply
-
-      if (max_range.size <
-          m_ranges[i].size) { // '?' symbols dominate, don't apply multiplier
-        continue;
-      }
-      max_range.size += m_ranges[i].size;
-      max_range.begin = std::min(max_range.begin, m_ranges[i].begin);
-      m_ranges.erase(m_ranges.begin() + i);
-      --i;
+    if (s != Symbol::question) {
+      ++i;
+      continue;
     }
+    uint32_t left_size = i > 0 ? m_ranges[i - 1].size : 0;
+    uint32_t right_size = i + 1 < m_ranges.size() ? m_ranges[i + 1].size : 0;
+
+    // If near ranges are equal don't apply,
+    // if '?' symbols dominate don't apply multiplier
+    if (left_size == right_size ||
+        std::max(left_size, right_size) < m_ranges[i].size) {
+      ++i;
+      continue;
+    }
+    // Biggest near range
+    bool to_right = right_size > left_size;
+    Range& max_range = m_ranges[to_right ? i + 1 : i - 1];
+    max_range.size += m_ranges[i].size;
+    max_range.begin = std::min(max_range.begin, m_ranges[i].begin);
+    m_ranges.erase(m_ranges.begin() + i);
+    // Range expanded to the left now starts with '?', step over it
+    i += to_right ? 1 : 0;
   }
 }
 
@@ -211,7 +184,7 @@ void Combination::apply_family_symbols()
   m_ranges.resize(unique_size);
 }
 
-Combination::Result Combination::get_result()
+Combination::Structure Combination::get_structure()
 {
   // In this order
   apply_questions();
@@ -230,14 +203,15 @@ Combination::Result Combination::get_result()
 
   // Weak combination
   if (combo.size < (g_nreels + 1) / 2) {
-    return { combo, 0, false };
+    return { combo, 0, Symbol::number, true };
   }
 
-  Range equal_symbols = get_max_equal_range(
-    reinterpret_cast<uint32_t*>(m_row.data() + combo.begin), combo.size);
+  Range equal_symbols =
+    get_max_equal_range(m_row.data() + combo.begin, combo.size);
   Symbol dominant = m_row[combo.begin + equal_symbols.begin];
 
-  // Have equal size '?' sequence on the left or in middle of real dominant sequence
+  // Have equal size '?' sequence on the left, on the right or in middle of
+  // real dominant sequence
   if (dominant == Symbol::question && equal_symbols.size < combo.size) {
     uint32_t cmb_beg = combo.begin;
     uint32_t cmb_end = cmb_beg + combo.size;
@@ -246,7 +220,8 @@ Combination::Result Combination::get_result()
 
     bool in_middle = es_beg > cmb_beg && es_end < cmb_end; 
     bool in_middle_dominated = in_middle && m_row[es_beg-1] == m_row[es_end];
-    if (in_middle_dominated) {
+    bool on_right = es_end == cmb_end;
+    if (in_middle_dominated || on_right) {
       dominant = m_row[es_beg-1];
     } else { // '?' sequence on the left
       dominant = m_row[es_end];
@@ -254,14 +229,64 @@ Combination::Result Combination::get_result()
     }
   }
 
-  uint32_t multiplier =
-    static_cast<uint32_t>(std::pow(big_multiplier, equal_symbols.size));
-  multiplier *= static_cast<uint32_t>(
-    std::pow(small_multiplier, combo.size - equal_symbols.size));
+  return { combo, equal_symbols.size, dominant, false };
+}
+
+Combination::Result Combination::get_result(const Paytable& pt)
+{
+  Structure st = get_structure();
+  if (st.is_weak) {
+    return { st.combo_range, 0, false };
+  }
 
   Result res;
-  res.combo_range = combo;
-  res.points = multiplier * get_symbol_base_value(dominant);
-  res.free_speen = dominant == Symbol::respin;
+  res.combo_range = st.combo_range;
+  res.points = pt.get_points(st.dominant, st.n_equal, st.combo_range.size);
+  res.free_speen = st.dominant == Symbol::respin;
   return res;
 }
+
+void Combination::evaluate(const SymbolRow* rows,
+                           size_t n_rows,
+                           ResultBuffer& out,
+                           const Paytable& pt)
+{
+  for (size_t i = 0; i < n_rows; ++i) {
+    out.push_back(PackedResult::pack(Combination(rows[i]).get_result(pt)));
+  }
+}
+
+
+Combination::PackedResult Combination::PackedResult::pack(
+  const Result& res) noexcept
+{
+  assert(res.combo_range.begin < 16 && res.combo_range.size < 16);
+  PackedResult packed;
+  packed.points = res.points;
+  packed.combo_range =
+    static_cast<uint8_t>(res.combo_range.begin | res.combo_range.size << 4);
+  packed.flags = res.free_speen ? free_spin_flag : 0;
+  return packed;
+}
+
+
+void ResultBuffer::reserve(size_t n)
+{
+  m_points.reserve(n);
+  m_combo_ranges.reserve(n);
+  m_flags.reserve(n);
+}
+
+void ResultBuffer::clear() noexcept
+{
+  m_points.clear();
+  m_combo_ranges.clear();
+  m_flags.clear();
+}
+
+void ResultBuffer::push_back(PackedResult res)
+{
+  m_points.push_back(res.points);
+  m_combo_ranges.push_back(res.combo_range);
+  m_flags.push_back(res.flags);
+}
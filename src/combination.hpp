@@ -4,12 +4,15 @@
 #define SLOT_MACHINE_COMBINATION
 
 #include "configuration.hpp"
+#include "paytable.hpp"
 #include "symbol.hpp"
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
+class ResultBuffer;
 class Combination
 {
 public:
@@ -27,16 +30,43 @@ public:
     uint32_t points;
     bool free_speen;
   };
+  // Result in 8 bytes for bulk storage
+  struct PackedResult
+  {
+    static constexpr uint8_t free_spin_flag = 1;
+
+    uint32_t points;
+    uint8_t combo_range; // begin in low half, size in high half
+    uint8_t flags;
+
+    static PackedResult pack(const Result& res) noexcept;
+  };
+  static_assert(g_nreels < 16, "Combo range must fit in packed result");
+  // Part of result that doesn't depend on paytable values
+  struct Structure
+  {
+    Range combo_range;
+    uint32_t n_equal; // dominant symbols in combo
+    Symbol dominant;
+    bool is_weak;
+  };
 
   Combination(SymbolRow row);
-  Result get_result();
+  // Use only one of these methods, they modify internal ranges
+  Structure get_structure();
+  Result get_result(const Paytable& pt = g_default_paytable);
+  // Appends results of all rows to buffer. Buffer grows geometrically,
+  // reserve it once for repeated calls
+  static void evaluate(const SymbolRow* rows,
+                       size_t n_rows,
+                       ResultBuffer& out,
+                       const Paytable& pt = g_default_paytable);
 
 private:
-  static constexpr uint32_t get_symbol_base_value(Symbol s) noexcept;
-  static constexpr uint32_t big_multiplier = 5;
-  static constexpr uint32_t small_multiplier = 2;
-  static Range get_max_equal_range(uint32_t* data, uint32_t size);
-  static ContinuosRanges get_ranges(uint32_t* data, uint32_t size);
+  template<class T>
+  static Range get_max_equal_range(const T* data, uint32_t size);
+  template<class T>
+  static ContinuosRanges get_ranges(const T* data, uint32_t size);
   // Substitute '?' symbols in some cases
   void apply_questions();
   // Break nearest to 'x' combinations
@@ -47,4 +77,28 @@ private:
   SymbolRow m_row;
   ContinuosRanges m_ranges;
 };
+
+
+// Packed results in structure of arrays layout
+class ResultBuffer
+{
+public:
+  using PackedResult = Combination::PackedResult;
+
+  void reserve(size_t n);
+  void clear() noexcept;
+  size_t size() const noexcept { return m_points.size(); }
+  void push_back(PackedResult res);
+  PackedResult operator[](size_t i) const noexcept
+  {
+    return { m_points[i], m_combo_ranges[i], m_flags[i] };
+  }
+  const std::vector<uint32_t>& get_points() const noexcept { return m_points; }
+  const std::vector<uint8_t>& get_flags() const noexcept { return m_flags; }
+
+private:
+  std::vector<uint32_t> m_points;
+  std::vector<uint8_t> m_combo_ranges;
+  std::vector<uint8_t> m_flags;
+};
 #endif
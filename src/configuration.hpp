@@ -15,15 +15,51 @@ static constexpr bool g_testing_enabled = false;
 static constexpr const char* g_wnd_title = "Slot machine";
 static constexpr uint16_t g_init_wnd_width = 800;
 static constexpr uint16_t g_init_wnd_height = 600;
+// Frame rate cap: 30, 60, 120 or 0 for uncapped, which also turns vsync off
 static constexpr uint16_t g_fps_cap = 60;
 static constexpr FloatSeconds g_standard_frame_time =
-  FloatSeconds(1.f / g_fps_cap);
+  FloatSeconds(g_fps_cap > 0 ? 1.f / g_fps_cap : 0.f);
+// Present waits for display refresh when renderer supports it. Limiter
+// paces frames only if cap is below refresh rate or vsync isn't available
+static constexpr bool g_vsync_enabled = true;
+// Limiter sleeps until this much before deadline, then spins
+static constexpr FloatSeconds g_pacer_spin_time{ 0.002f };
+// Log mean frame time and jitter every second
+static constexpr bool g_frame_stats_enabled = false;
+
+// Simulate with constant time step, frames interpolate reels between steps
+static constexpr bool g_fixed_timestep_enabled = true;
+static constexpr uint16_t g_simulation_rate = 240;
+static constexpr FloatSeconds g_simulation_step =
+  FloatSeconds(1.f / g_simulation_rate);
+// Simulation falls behind real time after longer stalls
+static constexpr FloatSeconds g_max_simulation_lag{ 0.25f };
+
+// Simulation thread builds frames, main thread only presents them.
+// Uncapped frames are still built at most once per simulation step
+static constexpr bool g_render_thread_enabled = false;
+
+// Submit adjacent primitives of one texture as single geometry call
+static constexpr bool g_batched_rendering_enabled = true;
+// Group primitives by texture and color where they don't overlap. Batches
+// span whole atlas pages and colors don't split them, so it rarely pays
+// for its overlap scan and copy. Check the gain with render stats first
+static constexpr bool g_render_sort_enabled = false;
+// Log render state changes before and after sorting every frame
+static constexpr bool g_render_stats_enabled = false;
 
 constexpr uint32_t g_nreels = 5;
 constexpr uint32_t g_nlines = 3;
 
+// Combo multipliers for dominant and adjacent (family, '?') symbols
+constexpr uint32_t g_big_multiplier = 5;
+constexpr uint32_t g_small_multiplier = 2;
+
 constexpr float g_reel_max_speed = 5.f;  // displays per second
 constexpr float g_reel_min_speed = 0.5f; // displays per second
+// Faster reels are drawn as one blurred strip instead of separate cards
+constexpr float g_reel_blur_speed = 2.f; // displays per second
+constexpr uint16_t g_blur_card_size = 128; // pixels in baked strip
 constexpr FloatSeconds g_min_speed_up_time{ 3.f };
 constexpr FloatSeconds g_max_speed_up_time{ 6.f };
 constexpr FloatSeconds g_min_spin_time = g_min_speed_up_time;
@@ -32,6 +68,13 @@ constexpr FloatSeconds g_min_stop_time{ 3.f };
 constexpr FloatSeconds g_max_stop_time{ 6.f };
 constexpr FloatSeconds g_result_show_time{ 2.f };
 constexpr FloatSeconds g_auto_spin_delay{ 0.5f };
+constexpr FloatSeconds g_hover_fade_time{ 0.15f };
+constexpr FloatSeconds g_highlight_fade_time{ 0.4f };
+
+// Predefined images are packed into shared textures of this size
+constexpr uint16_t g_atlas_page_size = 2048;
+// Edge texels repeated around packed image against filtering bleed
+constexpr uint16_t g_atlas_padding = 1;
 
 constexpr SDL_Color g_window_color{ 219, 218, 213, 255 };
 constexpr SDL_Color g_main_panel_color{ 223, 148, 18, 255 };
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#include "easing.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+float Easing::evaluate(float x) const noexcept
+{
+  switch (type) {
+    case EasingType::bezier:
+      return evaluate_bezier(params, x);
+    case EasingType::spring: {
+      const float w = params[0];
+      const float z = params[1];
+      const float wd = w * std::sqrt(1.f - z * z);
+      const float decay = std::exp(-z * w * x);
+      return 1.f -
+             decay * (std::cos(wd * x) + z * w / wd * std::sin(wd * x));
+    }
+    case EasingType::critically_damped: {
+      const float wx = params[0] * x;
+      return 1.f - (1.f + wx) * std::exp(-wx);
+    }
+    case EasingType::linear:
+    default:
+      return x;
+  }
+}
+
+
+AnimationBank::AnimationId AnimationBank::add(float value)
+{
+  AnimationId id = size();
+  m_easings.emplace_back();
+  m_times.push_back(1.f); // finished
+  m_inv_durations.push_back(1.f);
+  m_from.push_back(value);
+  m_to.push_back(value);
+  m_values.push_back(value);
+  return id;
+}
+
+void AnimationBank::reserve(uint32_t n)
+{
+  m_easings.reserve(n);
+  for (std::vector<float>* v :
+       { &m_times, &m_inv_durations, &m_from, &m_to, &m_values }) {
+    v->reserve(n);
+  }
+}
+
+void AnimationBank::advance(float dt) noexcept
+{
+  if (!m_running) {
+    return;
+  }
+
+  const AnimationId n = size();
+  bool running = false;
+  for (AnimationId i = 0; i < n; ++i) {
+    m_times[i] += dt;
+    const float x = std::min(m_times[i] * m_inv_durations[i], 1.f);
+    running |= x < 1.f;
+    // Physical curves don't reach the end exactly, so last value is snapped
+    const float progress = x < 1.f ? m_easings[i].evaluate(x) : 1.f;
+    m_values[i] = m_from[i] + (m_to[i] - m_from[i]) * progress;
+  }
+  m_running = running;
+}
+
+void AnimationBank::start(AnimationId id,
+                          float to,
+                          float time,
+                          const Easing& easing)
+{
+  if (time <= 0.f) {
+    set_value(id, to);
+    return;
+  }
+  m_easings[id] = easing;
+  m_times[id] = 0.f;
+  m_inv_durations[id] = 1.f / time;
+  m_from[id] = m_values[id];
+  m_to[id] = to;
+  m_running = true;
+}
+
+void AnimationBank::set_value(AnimationId id, float value) noexcept
+{
+  m_times[id] = 1.f;
+  m_inv_durations[id] = 1.f;
+  m_from[id] = m_to[id] = m_values[id] = value;
+}
+
+
+Animation::Animation(AnimationBank& bank, float value)
+  : m_bank(&bank)
+  , m_id(bank.add(value))
+{
+}
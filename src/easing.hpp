@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#ifndef SLOT_MACHINE_EASING
+#define SLOT_MACHINE_EASING
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+enum class EasingType : uint8_t
+{
+  linear = 0,
+  bezier,            // CSS like cubic Bezier from (0, 0) to (1, 1)
+  spring,            // underdamped oscillation around the end value
+  critically_damped, // fastest approach without overshoot
+  number
+};
+
+// Progress law over normalized time. Curves are plain values, so they can be
+// defined at compile time and stored in arrays without heap objects
+struct Easing
+{
+  EasingType type{ EasingType::linear };
+  std::array<float, 4> params{};
+
+  static constexpr Easing make_linear() noexcept { return {}; }
+  static constexpr Easing make_bezier(float x1,
+                                      float y1,
+                                      float x2,
+                                      float y2) noexcept
+  {
+    return { EasingType::bezier, { x1, y1, x2, y2 } };
+  }
+  // Angular frequency and damping ratio (< 1) per unit of normalized time
+  static constexpr Easing make_spring(float frequency,
+                                      float damping_ratio) noexcept
+  {
+    return { EasingType::spring, { frequency, damping_ratio } };
+  }
+  // Rate per unit of normalized time, larger settles sooner
+  static constexpr Easing make_critically_damped(float rate) noexcept
+  {
+    return { EasingType::critically_damped, { rate } };
+  }
+
+  // Progress at normalized time x in [0, 1]. Bezier and linear are
+  // constexpr, physical curves use exponent
+  float evaluate(float x) const noexcept;
+};
+
+// Newton iterations for curve parameter, then y at it
+constexpr float evaluate_bezier(const std::array<float, 4>& p, float x)
+{
+  // Polynomial coefficients of both coordinates
+  const float cx = 3.f * p[0];
+  const float bx = 3.f * (p[2] - p[0]) - cx;
+  const float ax = 1.f - cx - bx;
+  const float cy = 3.f * p[1];
+  const float by = 3.f * (p[3] - p[1]) - cy;
+  const float ay = 1.f - cy - by;
+
+  float t = x;
+  for (int i = 0; i < 6; ++i) {
+    const float err = ((ax * t + bx) * t + cx) * t - x;
+    const float slope = (3.f * ax * t + 2.f * bx) * t + cx;
+    if (slope > -1e-6f && slope < 1e-6f) {
+      break;
+    }
+    t -= err / slope;
+  }
+  t = t < 0.f ? 0.f : t > 1.f ? 1.f : t;
+  return ((ay * t + by) * t + cy) * t;
+}
+
+constexpr Easing g_ease_in_out = Easing::make_bezier(0.42f, 0.f, 0.58f, 1.f);
+constexpr Easing g_ease_out = Easing::make_bezier(0.f, 0.f, 0.58f, 1.f);
+constexpr Easing g_settle = Easing::make_critically_damped(8.f);
+
+
+// Scalar animations of UI elements in structure of arrays layout. All of
+// them are advanced in one pass, finished ones hold their end value.
+// Nothing is done while all are finished. Same layout as ReelBank, but
+// values are eased between two ends over a fixed time instead of following
+// a jerk motion law, so there is no wrapping, rest detection or clock
+// rebasing to share
+class AnimationBank
+{
+public:
+  using AnimationId = uint32_t;
+
+  AnimationId add(float value = 0.f);
+  uint32_t size() const noexcept { return m_values.size(); }
+  void reserve(uint32_t n);
+  void advance(float dt) noexcept;
+  // From current value to end value during time
+  void start(AnimationId id, float to, float time, const Easing& easing);
+  // Jumps to value, running animation is dropped
+  void set_value(AnimationId id, float value) noexcept;
+  float get_value(AnimationId id) const noexcept { return m_values[id]; }
+  bool is_running(AnimationId id) const noexcept
+  {
+    return m_times[id] * m_inv_durations[id] < 1.f;
+  }
+  // Any animation is running
+  bool is_running() const noexcept { return m_running; }
+
+private:
+  std::vector<Easing> m_easings;
+  std::vector<float> m_times; // since start
+  std::vector<float> m_inv_durations;
+  std::vector<float> m_from;
+  std::vector<float> m_to;
+  std::vector<float> m_values;
+  bool m_running{ false }; // advance does nothing otherwise
+};
+
+
+// Controls one animation of the bank
+class Animation
+{
+public:
+  Animation(AnimationBank& bank, float value = 0.f);
+  void start(float to, float time, const Easing& easing = g_ease_in_out)
+  {
+    m_bank->start(m_id, to, time, easing);
+  }
+  void set_value(float value) noexcept { m_bank->set_value(m_id, value); }
+  float get_value() const noexcept { return m_bank->get_value(m_id); }
+  bool is_running() const noexcept { return m_bank->is_running(m_id); }
+
+private:
+  AnimationBank* m_bank;
+  AnimationBank::AnimationId m_id;
+};
+#endif
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#ifndef SLOT_MACHINE_FIXED_POINT
+#define SLOT_MACHINE_FIXED_POINT
+
+#include <cstdint>
+
+// Signed 32.32 fixed point number. Sums are exact and resolution doesn't
+// depend on magnitude, so long sequences of small increments don't drift
+class Fixed32
+{
+public:
+  static constexpr int64_t one = int64_t{ 1 } << 32;
+
+  constexpr Fixed32() noexcept = default;
+  constexpr Fixed32(float value) noexcept
+    : Fixed32(static_cast<double>(value))
+  {
+  }
+  constexpr Fixed32(double value) noexcept
+    : m_raw(static_cast<int64_t>(value * static_cast<double>(one)))
+  {
+  }
+
+  static constexpr Fixed32 from_raw(int64_t raw) noexcept
+  {
+    Fixed32 res;
+    res.m_raw = raw;
+    return res;
+  }
+  constexpr int64_t raw() const noexcept { return m_raw; }
+
+  explicit constexpr operator float() const noexcept
+  {
+    return static_cast<float>(static_cast<double>(*this));
+  }
+  explicit constexpr operator double() const noexcept
+  {
+    return static_cast<double>(m_raw) / static_cast<double>(one);
+  }
+
+  constexpr Fixed32 operator-() const noexcept { return from_raw(-m_raw); }
+  constexpr Fixed32& operator+=(Fixed32 rhs) noexcept
+  {
+    m_raw += rhs.m_raw;
+    return *this;
+  }
+  constexpr Fixed32& operator-=(Fixed32 rhs) noexcept
+  {
+    m_raw -= rhs.m_raw;
+    return *this;
+  }
+
+  friend constexpr Fixed32 operator+(Fixed32 lhs, Fixed32 rhs) noexcept
+  {
+    return lhs += rhs;
+  }
+  friend constexpr Fixed32 operator-(Fixed32 lhs, Fixed32 rhs) noexcept
+  {
+    return lhs -= rhs;
+  }
+
+  // Full 64x64 bit product assembled from 32 bit halves, lowest fraction
+  // bits are truncated
+  friend constexpr Fixed32 operator*(Fixed32 lhs, Fixed32 rhs) noexcept
+  {
+    const bool negative = (lhs.m_raw < 0) != (rhs.m_raw < 0);
+    const uint64_t a = magnitude(lhs.m_raw);
+    const uint64_t b = magnitude(rhs.m_raw);
+    const uint64_t ah = a >> 32;
+    const uint64_t al = a & 0xFFFFFFFF;
+    const uint64_t bh = b >> 32;
+    const uint64_t bl = b & 0xFFFFFFFF;
+    const uint64_t res =
+      (ah * bh << 32) + ah * bl + al * bh + (al * bl >> 32);
+    const int64_t signed_res = static_cast<int64_t>(res);
+    return from_raw(negative ? -signed_res : signed_res);
+  }
+
+  // Rounded to double precision, which is enough for motion laws
+  friend constexpr Fixed32 operator/(Fixed32 lhs, Fixed32 rhs) noexcept
+  {
+    return Fixed32(static_cast<double>(lhs) / static_cast<double>(rhs));
+  }
+
+  friend constexpr bool operator==(Fixed32 lhs, Fixed32 rhs) noexcept
+  {
+    return lhs.m_raw == rhs.m_raw;
+  }
+  friend constexpr bool operator!=(Fixed32 lhs, Fixed32 rhs) noexcept
+  {
+    return lhs.m_raw != rhs.m_raw;
+  }
+  friend constexpr bool operator<(Fixed32 lhs, Fixed32 rhs) noexcept
+  {
+    return lhs.m_raw < rhs.m_raw;
+  }
+  friend constexpr bool operator<=(Fixed32 lhs, Fixed32 rhs) noexcept
+  {
+    return lhs.m_raw <= rhs.m_raw;
+  }
+  friend constexpr bool operator>(Fixed32 lhs, Fixed32 rhs) noexcept
+  {
+    return lhs.m_raw > rhs.m_raw;
+  }
+  friend constexpr bool operator>=(Fixed32 lhs, Fixed32 rhs) noexcept
+  {
+    return lhs.m_raw >= rhs.m_raw;
+  }
+
+private:
+  static constexpr uint64_t magnitude(int64_t v) noexcept
+  {
+    return v < 0 ? uint64_t{ 0 } - static_cast<uint64_t>(v)
+                 : static_cast<uint64_t>(v);
+  }
+
+  int64_t m_raw{ 0 };
+};
+#endif
@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#include "frame_pacer.hpp"
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+FramePacer::FramePacer(FloatSeconds period)
+  : m_period(std::chrono::duration_cast<Clock::duration>(period))
+  , m_deadline(Clock::now())
+  , m_report_time(Clock::now())
+{
+}
+
+void FramePacer::wait()
+{
+  if (m_period == Clock::duration::zero()) {
+    return;
+  }
+
+  m_deadline += m_period;
+  TimePoint now = Clock::now();
+  if (now >= m_deadline) {
+    // Missed frame starts new schedule instead of bursting to catch up
+    if (now - m_deadline > m_period) {
+      m_deadline = now;
+    }
+    return;
+  }
+
+  const auto spin_time =
+    std::chrono::duration_cast<Clock::duration>(g_pacer_spin_time);
+  if (m_deadline - now > spin_time) {
+    std::this_thread::sleep_until(m_deadline - spin_time);
+  }
+  while (Clock::now() < m_deadline) {
+    std::this_thread::yield();
+  }
+}
+
+void FramePacer::frame_presented()
+{
+  const TimePoint now = Clock::now();
+  if (m_has_last_present) {
+    const double interval = FloatSeconds(now - m_last_present).count();
+    m_intervals.add(interval);
+    m_max = std::max(m_max, interval);
+  }
+  m_last_present = now;
+  m_has_last_present = true;
+
+  if constexpr (g_frame_stats_enabled) {
+    report(now);
+  }
+}
+
+void FramePacer::reset()
+{
+  m_deadline = Clock::now();
+  m_has_last_present = false;
+}
+
+void FramePacer::report(TimePoint now)
+{
+  if (now - m_report_time < std::chrono::seconds(1) ||
+      m_intervals.get_count() == 0) {
+    return;
+  }
+
+  const double mean = m_intervals.get_mean();
+  SDL_Log("%.1f fps, frame %.2f ms, jitter %.2f ms, max %.2f ms",
+          1. / mean,
+          mean * 1000.,
+          std::sqrt(m_intervals.get_variance()) * 1000.,
+          m_max * 1000.);
+
+  m_report_time = now;
+  m_intervals = RunningMoments();
+  m_max = 0.;
+}
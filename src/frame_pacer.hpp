@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#ifndef SLOT_MACHINE_FRAME_PACER
+#define SLOT_MACHINE_FRAME_PACER
+
+#include "configuration.hpp"
+#include "statistics.hpp"
+
+// Keeps frames on absolute deadlines, so time spent on frame work isn't
+// added to the period. Sleeps most of the wait and spins the rest, since
+// sleep wakes up late by scheduler granularity. Also measures intervals
+// between presented frames
+class FramePacer
+{
+public:
+  // Zero period doesn't wait, e.g. uncapped or paced by vsync
+  explicit FramePacer(FloatSeconds period = FloatSeconds::zero());
+  // Blocks until next deadline
+  void wait();
+  // Records interval since previous presented frame
+  void frame_presented();
+  // After idle pause: deadlines restart now, pause isn't an interval
+  void reset();
+
+private:
+  // Logs mean frame time and jitter once a second
+  void report(TimePoint now);
+
+  using Clock = std::chrono::steady_clock;
+
+  Clock::duration m_period;
+  TimePoint m_deadline;
+  TimePoint m_last_present;
+  bool m_has_last_present{ false };
+
+  // Interval statistics since last report, seconds
+  TimePoint m_report_time;
+  RunningMoments m_intervals;
+  double m_max{ 0. };
+};
+#endif
@@ -10,9 +10,12 @@
 
 Game::Game(TextureCollection& tc)
   : m_rng(std::random_device()())
-  , m_timer_events()
+  , m_clock(std::chrono::steady_clock::now())
+  , m_timeline()
+  , m_statistics()
   , m_scene(tc)
   , m_machine(m_scene.get_machine())
+  , m_highlight(m_scene.get_animations())
   , m_state(std::make_unique<IdleState>(*this))
 {
   m_machine.get_start_btn().set_event_handler([this](const SDL_Event& e) {
@@ -26,18 +29,59 @@ Game::Game(TextureCollection& tc)
       handle_event(Event::stop_pressed);
     }
   });
+
+  for (Reel& r : m_machine.get_reels()) {
+    r.get_motion().set_rest_handler([this]() { on_reel_stopped(); });
+  }
 }
 
 void Game::update(float dt)
 {
-  check_timers();
+  advance_clock(dt);
   m_scene.update(dt);
+  if (m_highlight_fading) {
+    apply_highlight();
+    m_highlight_fading = m_highlight.is_running();
+  }
+}
+
+void Game::skip_idle(float dt)
+{
+  assert(!m_scene.is_animating());
+  advance_clock(dt);
+}
+
+void Game::advance_clock(float dt)
+{
+  using namespace std::chrono;
+  m_clock += duration_cast<steady_clock::duration>(FloatSeconds(dt));
+  if (m_clock >= m_timeline.get_next_time()) {
+    m_timeline.advance(m_clock);
+  }
+}
+
+FloatSeconds Game::get_idle_time() const noexcept
+{
+  if (m_scene.is_animating()) {
+    return FloatSeconds::zero();
+  }
+  const TimePoint next = m_timeline.get_next_time();
+  if (next == TimePoint::max()) {
+    return FloatSeconds::max();
+  }
+  return std::max(FloatSeconds(next - m_clock), FloatSeconds::zero());
+}
+
+void Game::interpolate(float alpha)
+{
+  m_scene.interpolate(alpha);
 }
 
 void Game::process_input(const SDL_Event& input_event)
 {
   m_machine.get_start_btn().handle_event(input_event);
   m_machine.get_stop_btn().handle_event(input_event);
+  m_scene.invalidate();
 }
 
 Game::SymbolRow Game::get_symbol_row()
@@ -55,20 +99,30 @@ Game::SymbolRow Game::get_symbol_row()
 void Game::set_symbol_row(const SymbolRow& row)
 {
   remove_highlight();
-  m_timer_events.clear();
+  m_timeline.clear();
   m_state.reset(new IdleState(*this));
 
   for (uint32_t i = 0; i < row.size(); ++i) {
     Reel& r = m_machine.get_reels()[i];
     r.get_motion().stop_in(static_cast<float>(row[i]), 1.f);
   }
-  add_timer_event(FloatSeconds{ 1.f }, Event::reels_stopped);
+  m_nspinning = row.size();
 }
 
 void Game::add_timer_event(FloatSeconds time, Event e)
 {
-  std::function<void()> handler = std::bind(&Game::handle_event, this, e);
-  m_timer_events.emplace_back(PostponedEvent{ time, handler });
+  using namespace std::chrono;
+  m_timeline.schedule(m_clock + duration_cast<steady_clock::duration>(time),
+                      [this, e]() { handle_event(e); });
+}
+
+void Game::on_reel_stopped()
+{
+  assert(m_nspinning > 0);
+  m_nspinning -= 1;
+  if (m_nspinning == 0) {
+    handle_event(Event::reels_stopped);
+  }
 }
 
 void Game::handle_event(Event e)
@@ -77,35 +131,34 @@ void Game::handle_event(Event e)
   if (next_state.get() != nullptr) {
     m_state = std::move(next_state);
   }
+  m_scene.invalidate(); // states change buttons and cards
 }
 
-void Game::check_timers()
+void Game::highlight_combo(Combination::Range r)
 {
-  for (auto it = m_timer_events.begin(); it != m_timer_events.end();) {
-    PostponedEvent& pe = *it;
-    if (pe.timer.is_expired()) {
-      pe.event_handler();
-
-      auto cur_it = it++;
-      m_timer_events.erase(cur_it);
-    } else {
-      ++it;
-    }
-  }
+  m_highlight_range = r;
+  m_highlight.set_value(0.f);
+  m_highlight.start(1.f, g_highlight_fade_time.count(), g_settle);
+  m_highlight_fading = true;
 }
 
-void Game::highlight_combo(Combination::Range r)
+void Game::apply_highlight()
 {
+  const Combination::Range range = m_highlight_range;
+  const SDL_Color color = mix_colors(
+    g_symbol_card_color, g_combo_highlight, m_highlight.get_value());
   SymbolRow row = get_symbol_row();
-  for (uint32_t i = r.begin; i < r.begin + r.size; ++i) {
+  for (uint32_t i = range.begin; i < range.begin + range.size; ++i) {
     Reel& r = m_machine.get_reels()[i];
     DrawableBox& c = r.get_card(static_cast<uint32_t>(row[i]));
-    c.set_cover_color(g_combo_highlight);
+    c.set_cover_color(color);
   }
 }
 
 void Game::remove_highlight()
 {
+  m_highlight_fading = false;
+  m_highlight.set_value(0.f);
   SymbolRow row = get_symbol_row();
   for (uint32_t i = 0; i < row.size(); ++i) {
     Reel& r = m_machine.get_reels()[i];
@@ -194,11 +247,12 @@ Game::SlowingDownState::SlowingDownState(Game& g)
 
   auto stop_time_dist = std::uniform_real_distribution<float>(
     g_min_stop_time.count(), g_max_stop_time.count());
-  auto stop_symbol_dist = std::uniform_int_distribution<>(0, g_nsymbols - 1);
+  const auto& weights = g_default_paytable.reel_weights;
+  auto stop_symbol_dist =
+    std::discrete_distribution<uint32_t>(weights.begin(), weights.end());
 
   std::vector<Reel>& reels = m_game.m_machine.get_reels();
 
-  float last_stop_in;
   for (uint32_t i = 0; i < g_nreels; ++i) {
     Reel& r = reels[i];
 
@@ -207,10 +261,9 @@ Game::SlowingDownState::SlowingDownState(Game& g)
     r.get_motion().stop_in(static_cast<float>(stop_pos), stop_in);
 
     m_stop_row[i] = static_cast<Symbol>(stop_pos); // write down result
-    last_stop_in = std::max(stop_in, last_stop_in);
   }
-
-  m_game.add_timer_event(FloatSeconds(last_stop_in), Event::reels_stopped);
+  // Last reel coming to rest triggers reels_stopped
+  m_game.m_nspinning = g_nreels;
 }
 
 std::unique_ptr<Game::State> Game::SlowingDownState::next(Event game_event)
@@ -231,6 +284,14 @@ Game::ResultState::ResultState(Game& g, SymbolRow stop_row)
 {
   Combination combo(stop_row);
   Combination::Result res = combo.get_result();
+  m_game.m_statistics.add(res.points, res.free_speen);
+  if constexpr (g_testing_enabled) {
+    const RunningMoments& points = m_game.m_statistics.get_spin_points();
+    SDL_Log("%u points. Spins: %llu, mean points: %.2f",
+            res.points,
+            static_cast<unsigned long long>(points.get_count()),
+            points.get_mean());
+  }
 
   m_game.m_machine.get_score_counter().set_score(res.points);
   if (res.points > 0) {
@@ -256,15 +317,3 @@ std::unique_ptr<Game::State> Game::ResultState::next(Event game_event)
   }
 }
 
-
-Game::Timer::Timer(FloatSeconds period)
-{
-  using namespace std::chrono;
-  m_expire_time =
-    steady_clock::now() + duration_cast<steady_clock::duration>(period);
-}
-
-bool Game::Timer::is_expired()
-{
-  return std::chrono::steady_clock::now() >= m_expire_time;
-}
@@ -5,9 +5,10 @@
 
 #include "combination.hpp"
 #include "scene.hpp"
+#include "statistics.hpp"
 #include "texture.hpp"
+#include "timeline.hpp"
 
-#include <list>
 #include <memory>
 #include <random>
 
@@ -18,10 +19,24 @@ public:
 
   Game(TextureCollection& tc);
   void update(float dt);
+  // Moves clock over idle time and runs events due then. Nothing animates,
+  // so scene isn't advanced and motion started by events begins at the end
+  void skip_idle(float dt);
+  // Reels state between last two updates, alpha in [0, 1]
+  void interpolate(float alpha);
   const Scene& get_scene() const noexcept { return m_scene; }
+  void bake_blur_strips(GraphicsSystem& gs) { m_scene.bake_blur_strips(gs); }
+  // Simulation time until state changes: zero while anything animates,
+  // FloatSeconds::max() if nothing happens until input
+  FloatSeconds get_idle_time() const noexcept;
+  bool has_changed() const noexcept { return m_scene.has_changed(); }
   void process_input(const SDL_Event& input_event);
   SymbolRow get_symbol_row();
   void set_symbol_row(const SymbolRow& row); // for tests
+  const SpinStatistics& get_statistics() const noexcept
+  {
+    return m_statistics;
+  }
 
 private:
   enum class Event
@@ -42,21 +57,29 @@ private:
   class SlowingDownState;
   class ResultState;
 
-  class Timer;
-  struct PostponedEvent;
-
   void add_timer_event(FloatSeconds time, Event e);
+  // Moves clock and runs due timeline events
+  void advance_clock(float dt);
   void handle_event(Event e);
-  void check_timers();
   // Highlight combo sybmols
   void highlight_combo(Combination::Range r);
   // Remove combo highlight
   void remove_highlight();
+  // Combo cards color at current fade value
+  void apply_highlight();
+  // Last spinning reel emits reels_stopped
+  void on_reel_stopped();
 
   std::mt19937 m_rng;
-  std::list<PostponedEvent> m_timer_events;
+  TimePoint m_clock; // simulation time, advanced by update
+  Timeline m_timeline;
+  SpinStatistics m_statistics;
   Scene m_scene;
   SlotMachine& m_machine;
+  Animation m_highlight; // 0 card color, 1 highlight color
+  Combination::Range m_highlight_range{ 0, 0 };
+  bool m_highlight_fading{ false };
+  uint32_t m_nspinning{ 0 }; // symbol reels not at rest
   std::unique_ptr<State> m_state;
 };
 
@@ -119,22 +142,4 @@ private:
   SymbolRow m_stop_row;
   bool m_auto_spin;
 };
-
-
-class Game::Timer
-{
-public:
-  Timer(FloatSeconds period);
-  bool is_expired();
-
-private:
-  TimePoint m_expire_time;
-};
-
-
-struct Game::PostponedEvent
-{
-  Timer timer;
-  std::function<void()> event_handler;
-};
 #endif
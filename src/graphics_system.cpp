@@ -2,6 +2,7 @@
 // Copyright © 2025 Mansur Mukhametzyanov
 #include "graphics_system.hpp"
 
+#include "configuration.hpp"
 #include "primitives.hpp"
 #include "texture.hpp"
 #include "utils.hpp"
@@ -27,34 +28,200 @@ GraphicsSystem::GraphicsSystem(std::string wnd_title,
     if (m_renderer == nullptr) {
       throw SdlError("Failed to create renderer");
     }
+    if constexpr (g_vsync_enabled && g_fps_cap > 0) {
+      m_vsync = SDL_SetRenderVSync(m_renderer, 1);
+      if (!m_vsync) {
+        SDL_Log("Vsync isn't available: %s", SDL_GetError());
+      }
+    }
   } catch (std::exception& ex) {
     this->~GraphicsSystem();
     throw ex;
   }
 }
 
+float GraphicsSystem::get_refresh_rate() const noexcept
+{
+  const SDL_DisplayMode* mode =
+    SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(m_wnd));
+  return mode != nullptr ? mode->refresh_rate : 0.f;
+}
+
 void GraphicsSystem::set_background_color(SDL_Color c)
 {
   m_bg_color = c;
 }
 
-void GraphicsSystem::draw(const DrawQueue& q)
+DrawQueue& GraphicsSystem::get_back_queue(TextureCollection& tc) noexcept
+{
+  DrawQueue& back = m_queues[m_front ^ 1];
+  back.reset(tc);
+  return back;
+}
+
+void GraphicsSystem::prepare_queue(DrawQueue& q)
+{
+  if constexpr (g_render_stats_enabled) {
+    SDL_Log("%u primitives, %u render state changes",
+            q.size(),
+            q.count_state_changes());
+  }
+  if constexpr (g_render_sort_enabled) {
+    q.sort_by_render_state();
+    if constexpr (g_render_stats_enabled) {
+      SDL_Log("%u render state changes after sorting",
+              q.count_state_changes());
+    }
+  }
+}
+
+void GraphicsSystem::present()
+{
+  m_front ^= 1;
+  present(m_queues[m_front]);
+}
+
+void GraphicsSystem::present(const DrawQueue& q)
 {
   SDL_SetRenderDrawColor(
     m_renderer, m_bg_color.r, m_bg_color.g, m_bg_color.b, m_bg_color.a);
   SDL_RenderClear(m_renderer);
+  submit(q);
+  SDL_RenderPresent(m_renderer);
+}
+
+SDL_Surface* GraphicsSystem::render_to_surface(const DrawQueue& q,
+                                               uint16_t width,
+                                               uint16_t height)
+{
+  SDL_Texture* target = SDL_CreateTexture(m_renderer,
+                                         SDL_PIXELFORMAT_RGBA32,
+                                         SDL_TEXTUREACCESS_TARGET,
+                                         width,
+                                         height);
+  if (target == nullptr) {
+    throw SdlError("Failed to create %ux%u render target", width, height);
+  }
+  SDL_SetRenderTarget(m_renderer, target);
+  SDL_SetRenderDrawColor(m_renderer, 0, 0, 0, 0);
+  SDL_RenderClear(m_renderer);
+  submit(q);
+  SDL_Surface* pixels = SDL_RenderReadPixels(m_renderer, nullptr);
+  SDL_SetRenderTarget(m_renderer, nullptr);
+  SDL_DestroyTexture(target);
+  if (pixels == nullptr) {
+    throw SdlError("Failed to read render target pixels");
+  }
 
-  for (DrawInfo di : q) {
-    if (di.texture_handler != nullptr) {
-      SDL_RenderTexture(
-        m_renderer, di.texture_handler, &di.tx_fragment, &di.bounds);
+  SDL_Surface* rgba = SDL_ConvertSurface(pixels, SDL_PIXELFORMAT_RGBA32);
+  SDL_DestroySurface(pixels);
+  if (rgba == nullptr) {
+    throw SdlError("Failed to convert render target pixels");
+  }
+  return rgba;
+}
+
+void GraphicsSystem::submit(const DrawQueue& q)
+{
+  if constexpr (g_batched_rendering_enabled) {
+    submit_batched(q);
+    return;
+  }
+
+  // Draw color is set only when it differs from previous box
+  bool color_set = false;
+  SDL_Color color{ 0, 0, 0, 0 };
+  for (const DrawInfo& di : q) {
+    const SDL_FRect bounds = di.get_bounds();
+    if (di.is_textured()) {
+      const TextureRegion& region = q.get_region(di);
+      const SDL_FRect fragment = di.get_fragment(region);
+      SDL_RenderTexture(m_renderer, region.handler, &fragment, &bounds);
     } else {
-      SDL_SetRenderDrawColor(
-        m_renderer, di.color.r, di.color.g, di.color.b, di.color.a);
-      SDL_RenderFillRect(m_renderer, &di.bounds);
+      const SDL_Color& c = di.color;
+      if (!color_set || c.r != color.r || c.g != color.g || c.b != color.b ||
+          c.a != color.a) {
+        SDL_SetRenderDrawColor(m_renderer, c.r, c.g, c.b, c.a);
+        color = c;
+        color_set = true;
+      }
+      SDL_RenderFillRect(m_renderer, &bounds);
     }
   }
-  SDL_RenderPresent(m_renderer);
+}
+
+void GraphicsSystem::submit_batched(const DrawQueue& q)
+{
+  // Painter's order is kept, so batch is a run of adjacent primitives with
+  // the same texture. Solid boxes are one run with vertex colors
+  m_vertices.clear();
+  SDL_Texture* batch_texture = nullptr;
+  uint32_t batch_begin = 0;
+  float inv_w = 1.f;
+  float inv_h = 1.f;
+
+  for (const DrawInfo& di : q) {
+    const TextureRegion* region =
+      di.is_textured() ? &q.get_region(di) : nullptr;
+    SDL_Texture* texture = region != nullptr ? region->handler : nullptr;
+    if (texture != batch_texture) {
+      flush_batch(batch_texture, batch_begin);
+      batch_texture = texture;
+      batch_begin = m_vertices.size();
+      if (batch_texture != nullptr) {
+        float w = 1.f;
+        float h = 1.f;
+        SDL_GetTextureSize(batch_texture, &w, &h);
+        inv_w = 1.f / w;
+        inv_h = 1.f / h;
+      }
+    }
+
+    const SDL_FRect b = di.get_bounds();
+    const float x[2] = { b.x, b.x + b.w };
+    const float y[2] = { b.y, b.y + b.h };
+    SDL_FColor color{ 1.f, 1.f, 1.f, 1.f };
+    float u[2] = { 0.f, 0.f };
+    float v[2] = { 0.f, 0.f };
+    if (region != nullptr) {
+      const SDL_FRect f = di.get_fragment(*region); // in texture pixels
+      u[0] = f.x * inv_w;
+      u[1] = (f.x + f.w) * inv_w;
+      v[0] = f.y * inv_h;
+      v[1] = (f.y + f.h) * inv_h;
+    } else {
+      color = { di.color.r / 255.f,
+                di.color.g / 255.f,
+                di.color.b / 255.f,
+                di.color.a / 255.f };
+    }
+    // Clockwise from top left corner
+    m_vertices.push_back({ { x[0], y[0] }, color, { u[0], v[0] } });
+    m_vertices.push_back({ { x[1], y[0] }, color, { u[1], v[0] } });
+    m_vertices.push_back({ { x[1], y[1] }, color, { u[1], v[1] } });
+    m_vertices.push_back({ { x[0], y[1] }, color, { u[0], v[1] } });
+  }
+  flush_batch(batch_texture, batch_begin);
+}
+
+void GraphicsSystem::flush_batch(SDL_Texture* texture, uint32_t first_vertex)
+{
+  const uint32_t nvertices = m_vertices.size() - first_vertex;
+  if (nvertices == 0) {
+    return;
+  }
+
+  const uint32_t nindices = nvertices / 4 * 6;
+  while (m_indices.size() < nindices) {
+    const int k = m_indices.size() / 6 * 4;
+    m_indices.insert(m_indices.end(), { k, k + 1, k + 2, k + 2, k + 3, k });
+  }
+  SDL_RenderGeometry(m_renderer,
+                     texture,
+                     m_vertices.data() + first_vertex,
+                     nvertices,
+                     m_indices.data(),
+                     nindices);
 }
 
 GraphicsSystem::~GraphicsSystem()
@@ -7,7 +7,9 @@
 
 #include <SDL3/SDL.h>
 
+#include <array>
 #include <cstdint>
+#include <vector>
 
 class TextureCollection;
 class GraphicsSystem
@@ -19,12 +21,45 @@ public:
   void run();
   ~GraphicsSystem();
   SDL_Renderer* get_renderer() noexcept { return m_renderer; }
+  // Present is synchronized with display refresh
+  bool has_vsync() const noexcept { return m_vsync; }
+  // Refresh rate of window display, 0 if unknown
+  float get_refresh_rate() const noexcept;
   void set_background_color(SDL_Color c);
-  void draw(const DrawQueue& q);
+  // Empty queue for next frame. Queues are persistent and double buffered,
+  // so steady frames don't allocate
+  DrawQueue& get_back_queue(TextureCollection& tc) noexcept;
+  // Last presented frame
+  const DrawQueue& get_front_queue() const noexcept
+  {
+    return m_queues[m_front];
+  }
+  // Sorts built queue by render state and logs render stats if enabled.
+  // Called by thread that builds frames, so sorting doesn't delay present
+  static void prepare_queue(DrawQueue& q);
+  // Draws back queue and makes it front one
+  void present();
+  // Draws queue built elsewhere
+  void present(const DrawQueue& q);
+  // Draws queue into offscreen RGBA32 surface, caller destroys it
+  SDL_Surface* render_to_surface(const DrawQueue& q,
+                                 uint16_t width,
+                                 uint16_t height);
 
 private:
+  void submit(const DrawQueue& q);
+  void submit_batched(const DrawQueue& q);
+  // Draws quads pushed since first vertex
+  void flush_batch(SDL_Texture* texture, uint32_t first_vertex);
+
   SDL_Window* m_wnd{ nullptr };
   SDL_Renderer* m_renderer{ nullptr };
   SDL_Color m_bg_color{ 0, 0, 0, 255 };
+  bool m_vsync{ false };
+  std::array<DrawQueue, 2> m_queues;
+  uint32_t m_front{ 0 };
+  // Batch buffers keep capacity between frames
+  std::vector<SDL_Vertex> m_vertices;
+  std::vector<int> m_indices; // same quad pattern for every batch
 };
 #endif
@@ -1,24 +1,33 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 // Copyright © 2025 Mansur Mukhametzyanov
 #include "configuration.hpp"
+#include "frame_pacer.hpp"
 #include "game.hpp"
 #include "graphics_system.hpp"
 #include "scene.hpp"
 #include "symbol.hpp"
 #include "texture.hpp"
+#include "triple_buffer.hpp"
+#include "utils.hpp"
 
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_events.h>
 #include <SDL3/SDL_main.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
 #include <cstdint>
 #include <exception>
 #include <ios>
 #include <iostream>
 #include <limits>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 
 class App
@@ -31,6 +40,14 @@ public:
     m_gs.set_background_color(g_window_color);
 
     m_game.reset(new Game(m_tc));
+    m_game->bake_blur_strips(m_gs);
+
+    if constexpr (g_render_thread_enabled) {
+      m_frame_event = SDL_RegisterEvents(1);
+      if (m_frame_event == 0) {
+        throw SdlError("Failed to register frame event");
+      }
+    }
 
     // Trigger next reels state using console input
     if constexpr (g_testing_enabled) {
@@ -44,7 +61,18 @@ public:
           char c{'\0'};
           std::cin.get(c);
           if (c == 'q') { // enter symbol to exit program 
-            m_quit_flag = true;
+            {
+              std::lock_guard<std::mutex> lock(m_input_mutex);
+              m_quit_flag = true;
+              m_input_cv.notify_one();
+            }
+            // Pipelined main thread sleeps until any SDL event
+            if (m_frame_event != 0) {
+              SDL_Event wake;
+              SDL_zero(wake);
+              wake.type = m_frame_event;
+              SDL_PushEvent(&wake);
+            }
             return;
           }
           std::cin.putback(c);
@@ -58,8 +86,10 @@ public:
             row[i] = static_cast<Symbol>(num % g_nsymbols);
             i = (i + 1) % row.size();
 
-            if (i == 0) { // full row
-              m_game->set_symbol_row(row);
+            if (i == 0) { // full row, game thread applies it
+              std::lock_guard<std::mutex> lock(m_input_mutex);
+              m_console_rows.push_back(row);
+              m_input_cv.notify_one();
             }
           }
         }
@@ -67,6 +97,12 @@ public:
       SDL_Log(help_message, g_nreels, g_nsymbols - 1);
     }
 
+    // Vsync paces frames unless cap is below refresh rate
+    const bool vsync_paces =
+      m_gs.has_vsync() && g_fps_cap >= m_gs.get_refresh_rate();
+    m_pacer = FramePacer(vsync_paces ? FloatSeconds::zero()
+                                     : g_standard_frame_time);
+
     m_update_time = std::chrono::steady_clock::now();
   }
 
@@ -78,6 +114,16 @@ public:
   }
 
   void run()
+  {
+    if constexpr (g_render_thread_enabled) {
+      run_pipelined();
+    } else {
+      run_serial();
+    }
+  }
+
+private:
+  void run_serial()
   {
     SDL_Event e;
     SDL_zero(e);
@@ -86,15 +132,15 @@ public:
       while (SDL_PollEvent(&e)) {
         switch (e.type) {
           case SDL_EVENT_QUIT:
-            m_quit_flag = true;
-            if constexpr (g_testing_enabled) {
-              // std::cin is blocked. Still waiting user enter something
-              SDL_Log("Enter any character to finish program");
-            }
+            quit();
             break;
           case SDL_EVENT_WINDOW_RESIZED:
             m_wnd_width = e.window.data1;
             m_wnd_height = e.window.data2;
+            m_redraw = true;
+            break;
+          case SDL_EVENT_WINDOW_EXPOSED:
+            m_redraw = true;
             break;
           case SDL_EVENT_MOUSE_MOTION:
           case SDL_EVENT_MOUSE_BUTTON_UP: {
@@ -105,30 +151,216 @@ public:
             break;
         }
       }
-      TimePoint frame_begin = std::chrono::steady_clock::now();
-      FloatSeconds dt = frame_begin - m_update_time;
-      m_update_time = frame_begin;
+      apply_console_rows();
+      simulate();
+      // Unchanged frame is neither built nor presented
+      if (m_redraw || m_game->has_changed()) {
+        DrawQueue& queue = m_gs.get_back_queue(m_tc);
+        m_game->get_scene().build(queue, m_wnd_width, m_wnd_height);
+        GraphicsSystem::prepare_queue(queue);
+        m_gs.present();
+        m_pacer.frame_presented();
+        m_redraw = false;
+      }
+
+      const FloatSeconds idle = m_game->get_idle_time();
+      if (idle > FloatSeconds::zero()) {
+        wait_events(idle);
+        m_pacer.reset();
+        continue;
+      }
+      m_pacer.wait();
+    }
+  }
+
+  // Main thread polls events and presents, simulation thread updates game
+  // and builds frames. SDL wants rendering and events on the main thread
+  void run_pipelined()
+  {
+    std::thread simulation([this]() { simulation_loop(); });
+
+    SDL_Event e;
+    SDL_zero(e);
+    while (!m_quit_flag) {
+      SDL_WaitEventTimeout(nullptr, -1); // input or new frame
+      bool redraw = false;
+      while (SDL_PollEvent(&e)) {
+        switch (e.type) {
+          case SDL_EVENT_QUIT:
+            quit();
+            break;
+          case SDL_EVENT_WINDOW_EXPOSED:
+            redraw = true;
+            break;
+          case SDL_EVENT_WINDOW_RESIZED:
+          case SDL_EVENT_MOUSE_MOTION:
+          case SDL_EVENT_MOUSE_BUTTON_UP: {
+            std::lock_guard<std::mutex> lock(m_input_mutex);
+            m_input.push_back(e);
+            m_input_cv.notify_one();
+            break;
+          }
+          default:
+            break;
+        }
+      }
+      // Latest frame only, skipped ones are never drawn
+      if (m_frames.fetch() || redraw) {
+        m_gs.present(m_frames.get_front());
+        m_pacer.frame_presented();
+      }
+    }
+    simulation.join();
+  }
+
+  void simulation_loop()
+  {
+    std::vector<SDL_Event> input;
+    bool redraw = true;
+    FramePacer pacer(g_fps_cap > 0 ? g_standard_frame_time
+                                   : g_simulation_step);
+    m_update_time = std::chrono::steady_clock::now();
+
+    while (!m_quit_flag) {
+      {
+        std::lock_guard<std::mutex> lock(m_input_mutex);
+        input.swap(m_input);
+      }
+      for (const SDL_Event& e : input) {
+        if (e.type == SDL_EVENT_WINDOW_RESIZED) {
+          m_wnd_width = e.window.data1;
+          m_wnd_height = e.window.data2;
+          redraw = true;
+        } else {
+          m_game->process_input(e);
+        }
+      }
+      input.clear();
+      apply_console_rows();
+
+      simulate();
+      if (redraw || m_game->has_changed()) {
+        DrawQueue& queue = m_frames.get_back();
+        queue.reset(m_tc);
+        m_game->get_scene().build(queue, m_wnd_width, m_wnd_height);
+        GraphicsSystem::prepare_queue(queue);
+        m_frames.publish();
+        redraw = false;
+
+        SDL_Event frame_ready;
+        SDL_zero(frame_ready);
+        frame_ready.type = m_frame_event;
+        SDL_PushEvent(&frame_ready);
+      }
+
+      // Animation keeps frame deadlines, input waits for next frame
+      const FloatSeconds idle = m_game->get_idle_time();
+      if (idle == FloatSeconds::zero()) {
+        pacer.wait();
+        continue;
+      }
+      // Input wakes idle simulation early
+      {
+        std::unique_lock<std::mutex> lock(m_input_mutex);
+        auto woken = [this]() {
+          return m_quit_flag || !m_input.empty() || !m_console_rows.empty();
+        };
+        if (idle == FloatSeconds::max()) {
+          m_input_cv.wait(lock, woken);
+        } else {
+          m_input_cv.wait_for(lock, idle, woken);
+        }
+      }
+      pacer.reset();
+    }
+  }
+
+  void simulate()
+  {
+    TimePoint now = std::chrono::steady_clock::now();
+    FloatSeconds dt = now - m_update_time;
+    m_update_time = now;
 
+    if constexpr (g_fixed_timestep_enabled) {
+      // Nothing moves until next event, so idle time is skipped at once.
+      // Motion started by the event runs in fixed steps after it
+      m_sim_lag += dt;
+      const FloatSeconds idle = std::min(m_game->get_idle_time(), m_sim_lag);
+      if (idle > FloatSeconds::zero()) {
+        m_game->skip_idle(idle.count());
+        m_sim_lag -= idle;
+      }
+      m_sim_lag = std::min(m_sim_lag, g_max_simulation_lag);
+      while (m_sim_lag >= g_simulation_step) {
+        m_game->update(g_simulation_step.count());
+        m_sim_lag -= g_simulation_step;
+      }
+      m_game->interpolate(m_sim_lag / g_simulation_step);
+    } else {
       m_game->update(dt.count());
-      m_gs.draw(m_game->get_scene().build(m_wnd_width, m_wnd_height));
+    }
+  }
 
-      TimePoint frame_end = std::chrono::steady_clock::now();
-      FloatSeconds frame_time;
-      if (frame_time < g_standard_frame_time) {
-        std::this_thread::sleep_for(g_standard_frame_time - frame_time);
+  // Rows entered in console. Only thread that updates game touches it
+  void apply_console_rows()
+  {
+    if constexpr (g_testing_enabled) {
+      std::vector<Game::SymbolRow> rows;
+      {
+        std::lock_guard<std::mutex> lock(m_input_mutex);
+        rows.swap(m_console_rows);
+      }
+      for (const Game::SymbolRow& row : rows) {
+        m_game->set_symbol_row(row);
       }
     }
   }
 
-private:
-  bool m_quit_flag {false};
+  void quit()
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_input_mutex);
+      m_quit_flag = true;
+      m_input_cv.notify_one();
+    }
+    if constexpr (g_testing_enabled) {
+      // std::cin is blocked. Still waiting user enter something
+      SDL_Log("Enter any character to finish program");
+    }
+  }
+
+  // Blocks until input or timeout. Console input doesn't wake SDL, so it's
+  // polled at frame rate in testing mode
+  void wait_events(FloatSeconds timeout)
+  {
+    if constexpr (g_testing_enabled) {
+      timeout = std::min(timeout, g_standard_frame_time);
+    }
+    Sint32 timeout_ms = -1; // infinite
+    if (timeout < FloatSeconds(std::numeric_limits<Sint32>::max() / 1000)) {
+      timeout_ms = static_cast<Sint32>(std::ceil(timeout.count() * 1000.f));
+    }
+    SDL_WaitEventTimeout(nullptr, timeout_ms); // event stays in queue
+  }
+
+  std::atomic<bool> m_quit_flag{ false };
+  bool m_redraw{ true }; // window contents lost
   GraphicsSystem m_gs{ g_wnd_title, g_init_wnd_width, g_init_wnd_height };
   TextureCollection m_tc{ "image_resources", 32 };
   uint16_t m_wnd_width{ g_init_wnd_width };
   uint16_t m_wnd_height{ g_init_wnd_height };
   TimePoint m_update_time;
+  FloatSeconds m_sim_lag{ 0.f }; // not simulated yet
+  FramePacer m_pacer;
   std::unique_ptr<Game> m_game{};
   std::unique_ptr<std::thread> m_input_thread{};
+  std::vector<Game::SymbolRow> m_console_rows; // guarded by m_input_mutex
+  // Pipelined mode
+  TripleBuffer<DrawQueue> m_frames; // built by simulation thread
+  std::vector<SDL_Event> m_input;   // for simulation thread
+  std::mutex m_input_mutex;
+  std::condition_variable m_input_cv;
+  Uint32 m_frame_event{ 0 };
 };
 
 
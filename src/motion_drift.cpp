@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+// Long run drift of motion precisions. Every spin speeds reel up, keeps full
+// speed and stops it with jerk profile at a random card. Spins are integrated
+// frame by frame and continue from unrounded stop position, so error of
+// every spin adds to the next one
+#include "animation.hpp"
+#include "fixed_point.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+constexpr float g_frame_time = 1.f / 60.f;
+constexpr double g_reel_length = 16.;
+constexpr double g_max_speed = 15.;
+constexpr float g_speed_up_time = 0.5f;
+constexpr float g_full_speed_time = 1.f;
+constexpr uint32_t g_seed = 1;
+
+struct Drift
+{
+  double max_error = 0.;
+  double last_error = 0.;
+  double ns_per_frame = 0.;
+};
+
+struct Spin
+{
+  float stop_time;
+  double target;
+};
+
+class SpinGenerator
+{
+public:
+  Spin next()
+  {
+    return { m_stop_time(m_rng), static_cast<double>(m_card(m_rng)) };
+  }
+
+private:
+  std::mt19937 m_rng{ g_seed };
+  std::uniform_real_distribution<float> m_stop_time{ 3.f, 6.f };
+  std::uniform_int_distribution<int32_t> m_card{ 0, 15 };
+};
+
+double circular_error(double position, double target)
+{
+  double d = std::abs(position - target);
+  return std::min(d, g_reel_length - d);
+}
+
+template<class T>
+void wrap(Motion<MotionType::jerked, T>& m)
+{
+  const T length = g_reel_length;
+  const double turns = std::floor(static_cast<double>(m.get_position()) /
+                                  static_cast<double>(length));
+  m.set_positon(m.get_position() - T(turns) * length);
+}
+
+template<class T>
+uint64_t integrate(Motion<MotionType::jerked, T>& m, float time)
+{
+  const uint64_t n_frames = static_cast<uint64_t>(time / g_frame_time);
+  for (uint64_t i = 0; i < n_frames; ++i) {
+    m.advance(g_frame_time);
+    wrap(m);
+  }
+  m.advance(time - n_frames * g_frame_time);
+  wrap(m);
+  return n_frames + 1;
+}
+
+template<class T>
+Drift measure(uint64_t n_spins)
+{
+  using namespace std::chrono;
+  Motion<MotionType::jerked, T> m({ T{}, T{}, T{}, T{} });
+  SpinGenerator gen;
+  Drift drift;
+  uint64_t n_frames = 0;
+
+  const auto begin = steady_clock::now();
+  for (uint64_t i = 0; i < n_spins; ++i) {
+    const Spin spin = gen.next();
+
+    m.set_acceleration(T(g_max_speed / g_speed_up_time));
+    n_frames += integrate(m, g_speed_up_time);
+    m.set_acceleration(T{});
+    m.set_speed(T(g_max_speed));
+    n_frames += integrate(m, g_full_speed_time);
+
+    // Same solution as ReelMotion::stop_in
+    const double t = spin.stop_time;
+    const double v = static_cast<double>(m.get_speed());
+    const double s0 = static_cast<double>(m.get_position());
+    const double l = g_reel_length;
+    const double k = std::ceil((v * t / 3. + s0 - spin.target) / l);
+    const double j =
+      12. * (s0 - spin.target - k * l + v * t / 2.) / (t * t * t);
+    const double a = -v / t - j * t / 2.;
+    m.set_jerk(T(j));
+    m.set_acceleration(T(a));
+    n_frames += integrate(m, spin.stop_time);
+    m.set_jerk(T{});
+    m.set_acceleration(T{});
+    m.set_speed(T{});
+
+    drift.last_error =
+      circular_error(static_cast<double>(m.get_position()), spin.target);
+    drift.max_error = std::max(drift.max_error, drift.last_error);
+  }
+  const duration<double, std::nano> elapsed = steady_clock::now() - begin;
+  drift.ns_per_frame = elapsed.count() / n_frames;
+  return drift;
+}
+
+// Game path: stop segment is evaluated directly at stop time and every
+// spin starts from exact position
+Drift measure_trajectory(uint64_t n_spins)
+{
+  SpinGenerator gen;
+  Drift drift;
+  float position = 0.f;
+  for (uint64_t i = 0; i < n_spins; ++i) {
+    const Spin spin = gen.next();
+    const float t = spin.stop_time;
+    const float v = g_max_speed;
+    const float s0 = std::fmod(
+      position + v * (g_speed_up_time / 2.f + g_full_speed_time),
+      static_cast<float>(g_reel_length));
+    const float s1 = spin.target;
+    const float l = g_reel_length;
+    const float k = std::ceil((v * t / 3.f + s0 - s1) / l);
+    const float j = 12.f * (s0 - s1 - k * l + v * t / 2.f) / (t * t * t);
+    const float a = -v / t - j * t / 2;
+
+    Trajectory tr(JerkMotion{ j, a, v, s0 });
+    const float end = std::fmod(tr.evaluate(t).get_position(), l);
+    drift.last_error = circular_error(end, spin.target);
+    drift.max_error = std::max(drift.max_error, drift.last_error);
+    position = s1;
+  }
+  return drift;
+}
+
+void print(const char* name, const Drift& drift)
+{
+  std::printf(
+    "%-12s %14.3e %14.3e", name, drift.max_error, drift.last_error);
+  if (drift.ns_per_frame > 0.) {
+    std::printf(" %14.2f\n", drift.ns_per_frame);
+  } else { // not integrated by frames
+    std::printf(" %14s\n", "-");
+  }
+}
+}
+
+int main(int argc, char* argv[])
+{
+  uint64_t n_spins = 100000;
+  if (argc > 2) {
+    std::printf("Usage: %s [spins]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (argc == 2) {
+    n_spins = std::strtoull(argv[1], nullptr, 10);
+  }
+
+  std::printf("%llu spins, stop position error in cards\n",
+              static_cast<unsigned long long>(n_spins));
+  std::printf("%-12s %14s %14s %14s\n",
+              "precision",
+              "max error",
+              "last error",
+              "ns/frame");
+  print("float", measure<float>(n_spins));
+  print("double", measure<double>(n_spins));
+  print("fixed 32.32", measure<Fixed32>(n_spins));
+  print("trajectory", measure_trajectory(n_spins));
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#ifndef SLOT_MACHINE_PAYTABLE
+#define SLOT_MACHINE_PAYTABLE
+
+#include "configuration.hpp"
+#include "symbol.hpp"
+
+#include <array>
+#include <cstdint>
+
+// Tunable values used to score combinations
+struct Paytable
+{
+  std::array<uint32_t, g_nsymbols> base_values;
+  std::array<uint32_t, g_nsymbols> reel_weights;
+  uint32_t big_multiplier;
+  uint32_t small_multiplier;
+
+  // Dominant symbols get big multiplier, the rest of combo gets small one
+  constexpr uint32_t get_points(Symbol dominant,
+                                uint32_t n_equal,
+                                uint32_t n_combo) const noexcept
+  {
+    uint32_t multiplier = 1;
+    for (uint32_t i = 0; i < n_combo; ++i) {
+      multiplier *= i < n_equal ? big_multiplier : small_multiplier;
+    }
+    return multiplier * base_values[static_cast<uint8_t>(dominant)];
+  }
+  // Upper bound of points of any combination
+  constexpr uint32_t get_max_points() const noexcept
+  {
+    uint32_t max_value = 0;
+    for (uint32_t v : base_values) {
+      max_value = v > max_value ? v : max_value;
+    }
+    uint32_t max_multiplier = big_multiplier > small_multiplier
+                                ? big_multiplier
+                                : small_multiplier;
+    uint32_t multiplier = 1;
+    for (uint32_t i = 0; i < g_nreels; ++i) {
+      multiplier *= max_multiplier;
+    }
+    return multiplier * max_value;
+  }
+};
+
+constexpr Paytable make_default_paytable() noexcept
+{
+  Paytable pt{};
+  for (uint32_t i = 0; i < g_nsymbols; ++i) {
+    pt.base_values[i] = g_symbol_descriptors[i].base_value;
+    pt.reel_weights[i] = g_symbol_descriptors[i].reel_weight;
+  }
+  pt.big_multiplier = g_big_multiplier;
+  pt.small_multiplier = g_small_multiplier;
+  return pt;
+}
+
+constexpr Paytable g_default_paytable = make_default_paytable();
+#endif
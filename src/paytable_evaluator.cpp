@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#include "paytable_evaluator.hpp"
+#include "combination.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+PaytableEvaluator::PaytableEvaluator()
+{
+  auto buckets = std::make_shared<std::vector<uint16_t>>(n_rows);
+
+  for (uint32_t n = 0; n < n_rows; ++n) {
+    Combination::SymbolRow row;
+    uint32_t digits = n;
+    for (uint32_t i = 0; i < g_nreels; ++i) {
+      row[i] = static_cast<Symbol>(digits % g_nsymbols);
+      digits /= g_nsymbols;
+    }
+
+    Combination::Structure st = Combination(row).get_structure();
+    if (st.is_weak) {
+      (*buckets)[n] = no_bucket;
+    } else {
+      uint32_t dominant = static_cast<uint8_t>(st.dominant);
+      assert(dominant < g_nsymbols);
+      assert(st.n_equal <= st.combo_range.size);
+      assert(st.combo_range.begin + st.combo_range.size <= g_nreels);
+      // Every row pays within the paytable range
+      assert(g_default_paytable.get_points(
+               st.dominant, st.n_equal, st.combo_range.size) <=
+             g_default_paytable.get_max_points());
+
+      uint32_t bucket =
+        (dominant * n_sizes + st.n_equal) * n_sizes + st.combo_range.size;
+      assert(bucket < no_bucket);
+      (*buckets)[n] = static_cast<uint16_t>(bucket);
+    }
+  }
+  m_row_buckets = std::move(buckets);
+}
+
+void PaytableEvaluator::update_probabilities(
+  const std::array<uint32_t, g_nsymbols>& weights)
+{
+  double weights_sum = 0.;
+  for (uint32_t w : weights) {
+    weights_sum += w;
+  }
+  assert(weights_sum > 0.);
+
+  std::array<double, g_nsymbols> symbol_prob;
+  for (uint32_t i = 0; i < g_nsymbols; ++i) {
+    symbol_prob[i] = weights[i] / weights_sum;
+  }
+
+  m_probabilities.fill(0.);
+  for (uint32_t n = 0; n < n_rows; ++n) {
+    uint16_t bucket = (*m_row_buckets)[n];
+    if (bucket == no_bucket) {
+      continue;
+    }
+    double row_prob = 1.;
+    uint32_t digits = n;
+    for (uint32_t i = 0; i < g_nreels; ++i) {
+      row_prob *= symbol_prob[digits % g_nsymbols];
+      digits /= g_nsymbols;
+    }
+    assert(bucket < no_bucket);
+    m_probabilities[bucket] += row_prob;
+  }
+  m_weights = weights;
+}
+
+PaytableEvaluator::Score PaytableEvaluator::evaluate(const Paytable& pt,
+                                                     uint32_t stake)
+{
+  assert(stake > 0);
+  if (pt.reel_weights != m_weights) {
+    update_probabilities(pt.reel_weights);
+  }
+
+  double mean = 0.;
+  double square_mean = 0.;
+  double respin_prob = 0.;
+  for (uint32_t b = 0; b < n_buckets; ++b) {
+    double p = m_probabilities[b];
+    if (p == 0.) {
+      continue;
+    }
+    uint32_t n_combo = b % n_sizes;
+    uint32_t n_equal = b / n_sizes % n_sizes;
+    Symbol dominant = static_cast<Symbol>(b / n_sizes / n_sizes);
+
+    uint32_t points = pt.get_points(dominant, n_equal, n_combo);
+    assert(points <= pt.get_max_points());
+    double ret = static_cast<double>(points) / static_cast<double>(stake);
+    mean += p * ret;
+    square_mean += p * ret * ret;
+    if (dominant == Symbol::respin) {
+      respin_prob += p;
+    }
+  }
+
+  Score score;
+  // Every respin is another spin without stake
+  score.rtp = mean / (1. - respin_prob);
+  score.mean = mean;
+  score.volatility = std::sqrt(std::max(0., square_mean - mean * mean));
+  return score;
+}
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#ifndef SLOT_MACHINE_PAYTABLE_EVALUATOR
+#define SLOT_MACHINE_PAYTABLE_EVALUATOR
+
+#include "configuration.hpp"
+#include "paytable.hpp"
+#include "symbol.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+constexpr uint32_t get_n_symbol_rows() noexcept
+{
+  uint32_t n = 1;
+  for (uint32_t i = 0; i < g_nreels; ++i) {
+    n *= g_nsymbols;
+  }
+  return n;
+}
+
+// Exact expected return of a paytable over all possible symbol rows.
+// Combination structure of every row is computed once, so scoring another
+// paytable only sums probabilities of rows with equal structure
+class PaytableEvaluator
+{
+public:
+  struct Score
+  {
+    double rtp;        // mean return per stake, free spins included
+    double mean;       // mean return of a single spin
+    double volatility; // standard deviation of a single spin return
+  };
+
+  PaytableEvaluator();
+  Score evaluate(const Paytable& pt, uint32_t stake);
+
+private:
+  // Rows with same dominant symbol, dominant and combo sizes have equal points
+  static constexpr uint32_t n_sizes = g_nreels + 1;
+  static constexpr uint32_t n_buckets = g_nsymbols * n_sizes * n_sizes;
+  static constexpr uint16_t no_bucket = n_buckets; // weak combination
+  static_assert(n_buckets < UINT16_MAX);
+
+  static constexpr uint32_t n_rows = get_n_symbol_rows();
+
+  void update_probabilities(const std::array<uint32_t, g_nsymbols>& weights);
+
+  // Row number is its symbols written in base g_nsymbols, first reel lowest
+  std::shared_ptr<const std::vector<uint16_t>> m_row_buckets;
+  // Weights bucket probabilities were computed for
+  std::array<uint32_t, g_nsymbols> m_weights{};
+  std::array<double, n_buckets> m_probabilities{};
+};
+#endif
@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+// Searches paytable values for a target return and volatility band
+#include "configuration.hpp"
+#include "paytable.hpp"
+#include "paytable_evaluator.hpp"
+#include "symbol.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+struct Target
+{
+  uint32_t stake;
+  double rtp;
+  double min_volatility;
+  double max_volatility;
+};
+
+struct Candidate
+{
+  Paytable paytable;
+  PaytableEvaluator::Score score;
+  double cost;
+};
+
+constexpr uint32_t g_max_base_value = 1000;
+constexpr uint32_t g_max_reel_weight = 32;
+constexpr uint32_t g_max_multiplier = 10;
+
+double get_cost(const PaytableEvaluator::Score& score, const Target& target)
+{
+  double cost = std::abs(score.rtp - target.rtp) / target.rtp;
+  if (score.volatility < target.min_volatility) {
+    cost += (target.min_volatility - score.volatility) / target.min_volatility;
+  } else if (score.volatility > target.max_volatility) {
+    cost += (score.volatility - target.max_volatility) / target.max_volatility;
+  }
+  return cost;
+}
+
+uint32_t step_value(uint32_t value,
+                    uint32_t min,
+                    uint32_t max,
+                    std::mt19937& rng)
+{
+  int32_t max_step = std::max<int32_t>(1, static_cast<int32_t>(value) / 4);
+  int32_t step = std::uniform_int_distribution<int32_t>(1, max_step)(rng);
+  if (rng() % 2 == 0) {
+    step = -step;
+  }
+  int32_t stepped = static_cast<int32_t>(value) + step;
+  return std::clamp<int32_t>(stepped, min, max);
+}
+
+// Change one value of the paytable
+Paytable get_neighbour(Paytable pt, std::mt19937& rng)
+{
+  uint32_t sy = std::uniform_int_distribution<uint32_t>(0, g_nsymbols - 1)(rng);
+
+  switch (std::uniform_int_distribution<uint32_t>(0, 9)(rng)) {
+    case 0:
+      pt.big_multiplier =
+        step_value(pt.big_multiplier, 2, g_max_multiplier, rng);
+      pt.small_multiplier =
+        std::min(pt.small_multiplier, pt.big_multiplier - 1);
+      break;
+    case 1:
+      pt.small_multiplier =
+        step_value(pt.small_multiplier, 1, pt.big_multiplier - 1, rng);
+      break;
+    case 2:
+    case 3:
+      pt.reel_weights[sy] =
+        step_value(pt.reel_weights[sy], 1, g_max_reel_weight, rng);
+      break;
+    default:
+      pt.base_values[sy] =
+        step_value(pt.base_values[sy], 1, g_max_base_value, rng);
+      break;
+  }
+  return pt;
+}
+
+// Simulated annealing from the default paytable
+Candidate anneal(PaytableEvaluator evaluator,
+                 const Target& target,
+                 uint32_t n_iterations,
+                 uint32_t seed)
+{
+  constexpr double initial_temperature = 0.1;
+  constexpr double final_temperature = 1e-4;
+  const double cooling = std::pow(final_temperature / initial_temperature,
+                                  1. / std::max(n_iterations, 1u));
+
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> chance(0., 1.);
+
+  Candidate cur;
+  cur.paytable = g_default_paytable;
+  cur.score = evaluator.evaluate(cur.paytable, target.stake);
+  cur.cost = get_cost(cur.score, target);
+  Candidate best = cur;
+
+  double temperature = initial_temperature;
+  for (uint32_t i = 0; i < n_iterations; ++i) {
+    Candidate next;
+    next.paytable = get_neighbour(cur.paytable, rng);
+    next.score = evaluator.evaluate(next.paytable, target.stake);
+    next.cost = get_cost(next.score, target);
+
+    double delta = next.cost - cur.cost;
+    if (delta < 0. || chance(rng) < std::exp(-delta / temperature)) {
+      cur = next;
+      if (cur.cost < best.cost) {
+        best = cur;
+      }
+    }
+    temperature *= cooling;
+  }
+  return best;
+}
+
+void print_candidate(const Candidate& c)
+{
+  std::printf("rtp: %.4f, volatility: %.4f\n\n", c.score.rtp,
+              c.score.volatility);
+  std::printf("configuration.hpp:\n");
+  std::printf("constexpr uint32_t g_big_multiplier = %u;\n",
+              c.paytable.big_multiplier);
+  std::printf("constexpr uint32_t g_small_multiplier = %u;\n\n",
+              c.paytable.small_multiplier);
+  std::printf("symbol.hpp (base value, reel weight):\n");
+  for (uint32_t i = 0; i < g_nsymbols; ++i) {
+    std::printf("  %-10s %u, %u\n", g_symbol_descriptors[i].name,
+                c.paytable.base_values[i], c.paytable.reel_weights[i]);
+  }
+}
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc < 5) {
+    std::printf("Usage: %s <stake> <target rtp> <min volatility> "
+                "<max volatility> [iterations]\n",
+                argv[0]);
+    return 1;
+  }
+  Target target;
+  target.stake = static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10));
+  target.rtp = std::strtod(argv[2], nullptr);
+  target.min_volatility = std::strtod(argv[3], nullptr);
+  target.max_volatility = std::strtod(argv[4], nullptr);
+  uint32_t n_iterations =
+    argc > 5 ? static_cast<uint32_t>(std::strtoul(argv[5], nullptr, 10))
+             : 20000;
+
+  if (target.stake == 0 || target.rtp <= 0. || target.min_volatility <= 0. ||
+      target.max_volatility < target.min_volatility) {
+    std::printf("Stake, rtp and volatility band must be positive\n");
+    return 1;
+  }
+
+  PaytableEvaluator evaluator;
+  Candidate initial;
+  initial.paytable = g_default_paytable;
+  initial.score = evaluator.evaluate(initial.paytable, target.stake);
+  initial.cost = get_cost(initial.score, target);
+  std::printf("Current paytable ");
+  print_candidate(initial);
+
+  // Independent annealing chains, each owns its evaluator copy.
+  // Copies share cached row structures
+  uint32_t n_threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<Candidate> results(n_threads);
+  std::vector<std::thread> threads;
+  std::random_device rd;
+  for (uint32_t i = 0; i < n_threads; ++i) {
+    uint32_t seed = rd();
+    threads.emplace_back([&, i, seed]() {
+      results[i] = anneal(evaluator, target, n_iterations, seed);
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+
+  auto best = std::min_element(
+    results.begin(), results.end(), [](const Candidate& l, const Candidate& r) {
+      return l.cost < r.cost;
+    });
+  std::printf("\nFound paytable ");
+  print_candidate(*best);
+  return 0;
+}
@@ -5,8 +5,10 @@
 #include "texture.hpp"
 
 #include <SDL3/SDL_pixels.h>
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cmath>
 #include <cstdint>
 
 Box<int> Grid::get_cell_box(uint16_t row, uint16_t column) const noexcept
@@ -66,50 +68,169 @@ FramedBox<int> FramedGrid::get_framed_box() const noexcept
 }
 
 
+namespace {
+// Window coordinates and sizes fit 16 bits, truncation would move the box
+int16_t pack_coordinate(int c) noexcept
+{
+  assert(c >= INT16_MIN && c <= INT16_MAX);
+  return static_cast<int16_t>(c);
+}
+
+uint16_t pack_uv(float f) noexcept
+{
+  return static_cast<uint16_t>(
+    std::lround(std::clamp(f, 0.f, 1.f) * DrawInfo::uv_scale));
+}
+
+bool overlap(const DrawInfo& a, const DrawInfo& b) noexcept
+{
+  return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h &&
+         b.y < a.y + a.h;
+}
+
+uint32_t pack_color(SDL_Color c) noexcept
+{
+  return static_cast<uint32_t>(c.r) << 24 | static_cast<uint32_t>(c.g) << 16 |
+         static_cast<uint32_t>(c.b) << 8 | static_cast<uint32_t>(c.a);
+}
+}
+
 DrawInfo::DrawInfo() noexcept
-  : bounds({ 0, 0, 0, 0 })
-  , color({ 0, 0, 0, 255 })
-  , texture_handler(nullptr)
+  : DrawInfo(Box<int>{ 0, 0, 0, 0 })
 {
 }
 
 DrawInfo::DrawInfo(Box<int> bounds) noexcept
-  : bounds(box_to_sdl_frect(bounds))
-  , color({ 0, 0, 0, 255 })
-  , texture_handler(nullptr)
+  : DrawInfo(bounds, SDL_Color{ 0, 0, 0, 255 })
 {
 }
 
 DrawInfo::DrawInfo(Box<int> bounds, SDL_Color color) noexcept
-  : bounds(box_to_sdl_frect(bounds))
-  , color(color)
-  , texture_handler(nullptr)
+  : x(pack_coordinate(bounds.x))
+  , y(pack_coordinate(bounds.y))
+  , w(pack_coordinate(bounds.w))
+  , h(pack_coordinate(bounds.h))
+  , uv{ 0, 0, 0, 0 } // unused bytes stay zero
+  , texture(NULL_TEXTURE)
+  , layer(0)
 {
+  this->color = color;
 }
 
 DrawInfo::DrawInfo(Box<int> bounds,
-                   Texture& texture,
+                   TextureId texture_id,
                    Box<float> tx_fragment) noexcept
-  : bounds(box_to_sdl_frect(bounds))
-  , texture_handler(texture.get_handler())
-  , tx_fragment(box_to_sdl_frect(tx_fragment))
+  : x(pack_coordinate(bounds.x))
+  , y(pack_coordinate(bounds.y))
+  , w(pack_coordinate(bounds.w))
+  , h(pack_coordinate(bounds.h))
+  , uv{ pack_uv(tx_fragment.x),
+        pack_uv(tx_fragment.y),
+        pack_uv(tx_fragment.x + tx_fragment.w),
+        pack_uv(tx_fragment.y + tx_fragment.h) }
+  , texture(static_cast<uint16_t>(texture_id))
+  , layer(0)
+{
+  assert(texture_id <= UINT16_MAX);
+}
+
+SDL_FRect DrawInfo::get_bounds() const noexcept
+{
+  return { static_cast<float>(x),
+           static_cast<float>(y),
+           static_cast<float>(w),
+           static_cast<float>(h) };
+}
+
+SDL_FRect DrawInfo::get_fragment(const TextureRegion& region) const noexcept
 {
-  // Texture coordinates scaling by texture size
-  this->tx_fragment.x *= static_cast<float>(texture.get_width());
-  this->tx_fragment.w *= static_cast<float>(texture.get_width());
-  this->tx_fragment.y *= static_cast<float>(texture.get_height());
-  this->tx_fragment.h *= static_cast<float>(texture.get_height());
+  // Texture coordinates scaling by region size, then moving into region
+  const float rw = static_cast<float>(region.w) / uv_scale;
+  const float rh = static_cast<float>(region.h) / uv_scale;
+  return { static_cast<float>(region.x) + uv[0] * rw,
+           static_cast<float>(region.y) + uv[1] * rh,
+           (uv[2] - uv[0]) * rw,
+           (uv[3] - uv[1]) * rh };
 }
 
 
 DrawQueue::DrawQueue(TextureCollection& tc, uint32_t reserved)
-  : m_tx_collection(tc)
+  : m_tx_collection(&tc)
 {
   if (reserved > 0) {
     m_queue.reserve(reserved);
   }
 }
 
+void DrawQueue::reset(TextureCollection& tc) noexcept
+{
+  m_queue.clear();
+  m_tx_collection = &tc;
+}
+
+void DrawQueue::sort_by_render_state()
+{
+  const uint32_t n = m_queue.size();
+  m_keys.resize(n);
+  for (uint32_t i = 0; i < n; ++i) {
+    DrawInfo& di = m_queue[i];
+    uint32_t layer = 0;
+    for (uint32_t j = 0; j < i; ++j) {
+      if (m_queue[j].layer >= layer && overlap(m_queue[j], di)) {
+        layer = m_queue[j].layer + 1;
+      }
+    }
+    di.layer = static_cast<uint16_t>(std::min<uint32_t>(layer, UINT16_MAX));
+    const bool textured = di.is_textured();
+    m_keys[i] = {
+      di.layer,
+      textured ? reinterpret_cast<uintptr_t>(get_region(di).handler) : 0,
+      textured ? 0 : pack_color(di.color),
+      i
+    };
+  }
+
+  // Index tie break makes plain sort stable without temporary buffer
+  std::sort(m_keys.begin(), m_keys.end(), [](SortKey a, SortKey b) {
+    if (a.layer != b.layer) {
+      return a.layer < b.layer;
+    }
+    if (a.page != b.page) {
+      return a.page < b.page;
+    }
+    if (a.color != b.color) {
+      return a.color < b.color;
+    }
+    return a.index < b.index;
+  });
+
+  m_sorted.clear();
+  for (const SortKey& k : m_keys) {
+    m_sorted.push_back(m_queue[k.index]);
+  }
+  m_queue.swap(m_sorted);
+}
+
+uint32_t DrawQueue::count_state_changes() const
+{
+  uint32_t changes = 0;
+  const SDL_Texture* texture = nullptr;
+  bool color_set = false;
+  uint32_t color = 0;
+  for (const DrawInfo& di : m_queue) {
+    if (di.is_textured()) {
+      const SDL_Texture* page = get_region(di).handler;
+      changes += page != texture ? 1 : 0;
+      texture = page;
+    } else if (!color_set || pack_color(di.color) != color) {
+      ++changes;
+      color = pack_color(di.color);
+      color_set = true;
+    }
+  }
+  return changes;
+}
+
 DrawQueue& DrawQueue::add_colored_box(Box<int> b, SDL_Color color)
 {
   if (b.area() > 0) {
@@ -123,8 +244,7 @@ DrawQueue& DrawQueue::add_textured_box(Box<int> b,
                                        Box<float> tx_fragment)
 {
   if (b.area() > 0) {
-    m_queue.push_back(
-      DrawInfo(b, m_tx_collection.get_texture(tx_id), tx_fragment));
+    m_queue.push_back(DrawInfo(b, tx_id, tx_fragment));
   }
   return *this;
 }
@@ -158,8 +278,7 @@ DrawQueue& DrawQueue::add_textured_frame(FramedBox<int> fb, TextureId tx_id)
 
   for (uint32_t i = 0; i < bases.size(); ++i) {
     if (bases[i].area() > 0) {
-      m_queue.emplace_back(
-        bases[i], m_tx_collection.get_texture(tx_id), tx_fragments[i]);
+      m_queue.emplace_back(bases[i], tx_id, tx_fragments[i]);
     }
   }
   return *this;
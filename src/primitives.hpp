@@ -11,7 +11,6 @@
 #include <array>
 #include <cassert>
 #include <cstdint>
-#include <cstring>
 #include <vector>
 
 template<class T>
@@ -24,6 +23,12 @@ struct Box
 
   T area() const noexcept { return w * h; }
 
+  bool operator==(const Box<T>& rhs) const noexcept
+  {
+    return x == rhs.x && y == rhs.y && w == rhs.w && h == rhs.h;
+  }
+  bool operator!=(const Box<T>& rhs) const noexcept { return !(*this == rhs); }
+
   void indent(T val) noexcept
   {
     x += val;
@@ -199,39 +204,66 @@ struct FramedGrid : public Grid
 };
 
 
+// Overshooting easings give t outside [0, 1], colors saturate at the ends
+inline SDL_Color mix_colors(SDL_Color from, SDL_Color to, float t) noexcept
+{
+  t = t < 0.f ? 0.f : t > 1.f ? 1.f : t;
+  auto mix = [t](uint8_t a, uint8_t b) {
+    return static_cast<uint8_t>(a + (static_cast<float>(b) - a) * t + 0.5f);
+  };
+  return { mix(from.r, to.r),
+           mix(from.g, to.g),
+           mix(from.b, to.b),
+           mix(from.a, to.a) };
+}
+
+
+// Compact drawing command, converted to SDL floats only at submission.
+// Plain bytes without padding, so queues are cheap to copy, compare and
+// hash: a reel is a few cache lines
 struct DrawInfo
 {
   DrawInfo() noexcept;
   DrawInfo(Box<int> bounds) noexcept;
   DrawInfo(Box<int> bounds, SDL_Color color) noexcept;
+  // Fragment is relative to texture region
   DrawInfo(Box<int> bounds,
-           Texture& texture,
+           TextureId texture_id,
            Box<float> tx_fragment = { 0.f, 0.f, 1.f, 1.f }) noexcept;
 
-  template<class T>
-  static SDL_FRect box_to_sdl_frect(Box<T> box) noexcept
-  {
-    Box<float> fbox = box.template cast_to<float>();
-    SDL_FRect sdl_box;
-    std::memcpy(&sdl_box, &fbox, sizeof(fbox));
+  bool is_textured() const noexcept { return texture != NULL_TEXTURE; }
+  SDL_FRect get_bounds() const noexcept;
+  // Fragment in pixels of region's texture
+  SDL_FRect get_fragment(const TextureRegion& region) const noexcept;
 
-    return sdl_box;
-  }
+  static constexpr float uv_scale = 65535.f;
 
-  SDL_FRect bounds;
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
   union
   {
-    SDL_FRect tx_fragment;
+    std::array<uint16_t, 4> uv; // fragment corners, 1 / uv_scale of region
     SDL_Color color;
   };
-  SDL_Texture* texture_handler;
+  uint16_t texture; // NULL_TEXTURE for colored box
+  uint16_t layer;   // assigned by render state sort
 };
+static_assert(sizeof(DrawInfo) == 20, "DrawInfo has padding");
 
 
+// Primitives of one frame. Clearing keeps capacity, so queue reused every
+// frame stops allocating once it reaches the largest frame size
 class DrawQueue
 {
 public:
+  DrawQueue() noexcept = default;
   DrawQueue(TextureCollection& tc, uint32_t reserved = 0);
+  // Empties queue and binds it to texture collection
+  void reset(TextureCollection& tc) noexcept;
+  uint32_t size() const noexcept { return m_queue.size(); }
+  uint32_t capacity() const noexcept { return m_queue.capacity(); }
   DrawQueue& add_textured_box(Box<int> b,
                               TextureId tx_id,
                               Box<float> tx_fragment = { 0.f, 0.f, 1.f, 1.f });
@@ -243,9 +275,66 @@ public:
     return m_queue.begin();
   }
   std::vector<DrawInfo>::const_iterator end() const { return m_queue.end(); }
+  void append(std::vector<DrawInfo>::const_iterator first,
+              std::vector<DrawInfo>::const_iterator last)
+  {
+    m_queue.insert(m_queue.end(), first, last);
+  }
+  // Orders by layer, texture and color. Layer of primitive is one above
+  // the highest earlier primitive it overlaps, so overlapping ones keep
+  // painter's order and only independent ones are regrouped
+  void sort_by_render_state();
+  // Texture switches and draw color changes to submit queue in order
+  uint32_t count_state_changes() const;
+  // Region of textured command
+  const TextureRegion& get_region(const DrawInfo& di) const
+  {
+    assert(m_tx_collection != nullptr && di.is_textured());
+    return m_tx_collection->get_region(di.texture);
+  }
 
 private:
+  struct SortKey
+  {
+    uint32_t layer;
+    uintptr_t page; // texture of region, batches span whole atlas page
+    uint32_t color; // 0 for textured
+    uint32_t index; // keeps sort stable
+  };
+
   std::vector<DrawInfo> m_queue;
-  TextureCollection& m_tx_collection;
+  TextureCollection* m_tx_collection{ nullptr };
+  // Sorting scratch, keeps capacity like queue
+  std::vector<SortKey> m_keys;
+  std::vector<DrawInfo> m_sorted;
+};
+
+
+// Commands of retained node, replayed until node changes or gets other
+// bounds. Recording reuses capacity
+class DrawCache
+{
+public:
+  bool is_valid(Box<int> bounds) const noexcept
+  {
+    return m_valid && bounds == m_bounds;
+  }
+  void invalidate() noexcept { m_valid = false; }
+  // Keeps commands added to queue since mark
+  void record(const DrawQueue& q, uint32_t mark, Box<int> bounds)
+  {
+    m_commands.assign(q.begin() + mark, q.end());
+    m_bounds = bounds;
+    m_valid = true;
+  }
+  void replay(DrawQueue& q) const
+  {
+    q.append(m_commands.begin(), m_commands.end());
+  }
+
+private:
+  std::vector<DrawInfo> m_commands;
+  Box<int> m_bounds{ 0, 0, 0, 0 };
+  bool m_valid{ false };
 };
 #endif
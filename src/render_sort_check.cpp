@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+// Render state sort must not change the picture. Random queues of
+// overlapping colored boxes are painted in software before and after
+// DrawQueue::sort_by_render_state and compared pixel by pixel
+#include "primitives.hpp"
+
+#include <SDL3/SDL_pixels.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr int32_t g_canvas_size = 64;
+constexpr uint32_t g_max_boxes = 150;
+constexpr uint32_t g_seed = 1;
+
+// Last box covering pixel wins, like painter's order of submission
+void paint(const DrawQueue& q, std::vector<uint32_t>& canvas)
+{
+  std::fill(canvas.begin(), canvas.end(), 0);
+  for (const DrawInfo& di : q) {
+    const uint32_t c = di.color.r << 16 | di.color.g << 8 | di.color.b;
+    for (int32_t y = di.y; y < di.y + di.h; ++y) {
+      for (int32_t x = di.x; x < di.x + di.w; ++x) {
+        canvas[y * g_canvas_size + x] = c;
+      }
+    }
+  }
+}
+
+// Few distinct colors, so sorting has something to regroup
+DrawQueue make_queue(std::mt19937& rng)
+{
+  std::uniform_int_distribution<uint32_t> n_boxes(1, g_max_boxes);
+  std::uniform_int_distribution<int32_t> pos(0, g_canvas_size - 2);
+  std::uniform_int_distribution<uint32_t> channel(0, 3);
+
+  DrawQueue q;
+  const uint32_t n = n_boxes(rng);
+  for (uint32_t i = 0; i < n; ++i) {
+    const int32_t x = pos(rng);
+    const int32_t y = pos(rng);
+    const int32_t w =
+      std::uniform_int_distribution<int32_t>(1, g_canvas_size - x)(rng);
+    const int32_t h =
+      std::uniform_int_distribution<int32_t>(1, g_canvas_size - y)(rng);
+    const SDL_Color color{ static_cast<uint8_t>(channel(rng)),
+                           static_cast<uint8_t>(channel(rng) % 3),
+                           1,
+                           255 };
+    q.add_colored_box({ x, y, w, h }, color);
+  }
+  return q;
+}
+}
+
+int main(int argc, char* argv[])
+{
+  uint32_t n_queues = 1000;
+  if (argc > 2) {
+    std::printf("Usage: %s [queues]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (argc == 2) {
+    n_queues = static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10));
+  }
+
+  std::mt19937 rng(g_seed);
+  std::vector<uint32_t> before(g_canvas_size * g_canvas_size);
+  std::vector<uint32_t> after(g_canvas_size * g_canvas_size);
+  uint64_t changes_before = 0;
+  uint64_t changes_after = 0;
+  uint32_t n_differ = 0;
+  for (uint32_t i = 0; i < n_queues; ++i) {
+    DrawQueue q = make_queue(rng);
+    paint(q, before);
+    changes_before += q.count_state_changes();
+    q.sort_by_render_state();
+    changes_after += q.count_state_changes();
+    paint(q, after);
+    n_differ += before != after ? 1 : 0;
+  }
+
+  std::printf("%u queues, render state changes: %llu before, %llu after\n",
+              n_queues,
+              static_cast<unsigned long long>(changes_before),
+              static_cast<unsigned long long>(changes_after));
+  if (n_differ > 0) {
+    std::printf("Error: sorting changed %u pictures\n", n_differ);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
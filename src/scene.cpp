@@ -2,9 +2,11 @@
 // Copyright © 2025 Mansur Mukhametzyanov
 #include "scene.hpp"
 #include "configuration.hpp"
+#include "graphics_system.hpp"
 #include "primitives.hpp"
 #include "symbol.hpp"
 #include "texture.hpp"
+#include "utils.hpp"
 
 #include <cassert>
 #include <cmath>
@@ -106,10 +108,10 @@ void DrawableBox::draw_helper(DrawQueue& queue,
 }
 
 
-Reel::Reel(uint16_t n_cards, uint16_t n_lines_visible) noexcept
+Reel::Reel(ReelBank& bank, uint16_t n_cards, uint16_t n_lines_visible)
   : m_cards(n_cards)
   , m_nlines(n_lines_visible)
-  , m_motion_state(static_cast<float>(n_cards))
+  , m_motion_state(bank, static_cast<float>(n_cards))
 {
 }
 
@@ -117,16 +119,40 @@ void Reel::resize(uint16_t n_cards)
 {
   m_motion_state.set_reel_length(static_cast<float>(n_cards));
   m_cards.resize(n_cards);
+  m_cache.invalidate();
+}
+
+bool Reel::is_blurred() const noexcept
+{
+  return m_blur_texture != NULL_TEXTURE &&
+         m_motion_state.get_speed() >= g_reel_blur_speed * m_nlines;
 }
 
 void Reel::draw(DrawQueue& queue, Box<int> bounds) const
+{
+  const float pos = m_motion_state.get_render_position();
+  const bool blurred = is_blurred();
+  if (m_cache.is_valid(bounds) && pos == m_cached_pos &&
+      blurred == m_cached_blurred) {
+    m_cache.replay(queue);
+    return;
+  }
+
+  const uint32_t mark = queue.size();
+  draw_cards(queue, bounds);
+  m_cache.record(queue, mark, bounds);
+  m_cached_pos = pos;
+  m_cached_blurred = blurred;
+}
+
+void Reel::draw_cards(DrawQueue& queue, Box<int> bounds) const
 {
   const uint16_t n_cards = m_cards.size();
   const float length = static_cast<float>(n_cards);
   const uint16_t px_card_height = bounds.h / m_nlines;
 
   // Logical position coresponds to bottom row. Need to shift it to the middle
-  const float shifted_pos = m_motion_state.get_position();
+  const float shifted_pos = m_motion_state.get_render_position();
   const float dist_to_middle = static_cast<float>(m_nlines / 2);
 
   // Last symbols are visible now
@@ -135,6 +161,17 @@ void Reel::draw(DrawQueue& queue, Box<int> bounds) const
     visual_pos += length;
   }
 
+  // Fast cards are indistinguishable anyway, strip is drawn as one quad
+  if (is_blurred()) {
+    const float strip_length = length + static_cast<float>(m_nlines);
+    Box<float> window{ 0.f,
+                       (length - visual_pos) / strip_length,
+                       1.f,
+                       static_cast<float>(m_nlines) / strip_length };
+    queue.add_textured_box(bounds, m_blur_texture, window);
+    return;
+  }
+
   // *_part values measured in fractions of reel length. 0.0 <= *_part <= 1.0
   const float rotation_part = visual_pos / length;
   // Drawable part of reel
@@ -170,8 +207,53 @@ void Reel::draw(DrawQueue& queue, Box<int> bounds) const
 }
 
 
-Button::Button(std::function<void(const SDL_Event&)> event_handler)
+Texture Reel::bake_blur_strip(GraphicsSystem& gs,
+                              TextureCollection& tc,
+                              uint16_t card_width,
+                              uint16_t card_height) const
+{
+  const int n_cards = m_cards.size();
+  const int cycle_height = n_cards * card_height;
+  const int repeat_height = m_nlines * card_height;
+
+  // Next cards are higher, as in draw
+  DrawQueue cards(tc, n_cards * 8);
+  for (int i = 0; i < n_cards; ++i) {
+    Box<int> card_bounds{
+      0, (n_cards - 1 - i) * card_height, card_width, card_height
+    };
+    m_cards[i].draw(cards, card_bounds);
+  }
+  SDL_Surface* cycle = gs.render_to_surface(cards, card_width, cycle_height);
+  // Path of max speed reel during one frame
+  blur_vertically(cycle, card_height / 4);
+
+  SDL_Surface* strip = SDL_CreateSurface(
+    card_width, cycle_height + repeat_height, SDL_PIXELFORMAT_RGBA32);
+  if (strip == nullptr) {
+    SDL_DestroySurface(cycle);
+    throw SdlError("Failed to create reel strip surface");
+  }
+  SDL_SetSurfaceBlendMode(cycle, SDL_BLENDMODE_NONE);
+  SDL_Rect first_cards{
+    0, cycle_height - repeat_height, card_width, repeat_height
+  };
+  SDL_Rect top{ 0, 0, card_width, repeat_height };
+  SDL_BlitSurface(cycle, &first_cards, strip, &top);
+  SDL_Rect rest{ 0, repeat_height, card_width, cycle_height };
+  SDL_BlitSurface(cycle, nullptr, strip, &rest);
+  SDL_DestroySurface(cycle);
+
+  Texture texture = Texture::from_surface(strip, gs);
+  SDL_DestroySurface(strip);
+  return texture;
+}
+
+
+Button::Button(AnimationBank& bank,
+               std::function<void(const SDL_Event&)> event_handler)
   : m_handler(event_handler)
+  , m_hover(bank)
 {
 }
 
@@ -184,12 +266,19 @@ void Button::draw(DrawQueue& queue, Box<int> bounds) const
       m_disabled_apperance.draw(queue, bounds);
       break;
     case State::idle:
-    case State::clicked: // not implemented
-      m_default_appearance.draw(queue, bounds);
-      break;
     case State::focused:
-      m_hover_appearance.draw(queue, bounds);
+    case State::clicked: { // not implemented
+      // Appearances differ by cover color, it fades between them
+      DrawableBox appearance = m_hover.get_value() < 0.5f
+                                 ? m_default_appearance
+                                 : m_hover_appearance;
+      appearance.set_cover_color(
+        mix_colors(m_default_appearance.get_cover_color(),
+                   m_hover_appearance.get_cover_color(),
+                   m_hover.get_value()));
+      appearance.draw(queue, bounds);
       break;
+    }
     default:
       break;
   }
@@ -206,21 +295,21 @@ void Button::handle_event(const SDL_Event& e)
     return;
   }
 
-  float f_x, f_y;
-  SDL_GetMouseState(&f_x, &f_y);
-  int i_x = iround(f_x);
-  int i_y = iround(f_y);
+  // Position at the time of event, also valid off the main thread
+  const bool motion = e.type == SDL_EVENT_MOUSE_MOTION;
+  int i_x = iround(motion ? e.motion.x : e.button.x);
+  int i_y = iround(motion ? e.motion.y : e.button.y);
   if (!m_hitbox.contains(i_x, i_y)) {
-    m_state = State::idle;
+    set_state(State::idle);
     return;
   }
 
   switch (e.type) {
     case SDL_EVENT_MOUSE_MOTION:
-      m_state = State::focused;
+      set_state(State::focused);
       break;
     case SDL_EVENT_MOUSE_BUTTON_DOWN:
-      m_state = State::clicked;
+      set_state(State::clicked);
       break;
     case SDL_EVENT_MOUSE_BUTTON_UP: // not implemented
     case SDL_EVENT_MOUSE_WHEEL:     // not implemented
@@ -231,6 +320,22 @@ void Button::handle_event(const SDL_Event& e)
   m_handler(e);
 }
 
+void Button::set_enbaled(bool f_enabled) noexcept
+{
+  m_state = f_enabled ? State::idle : State::disabled;
+  m_hover.set_value(0.f);
+}
+
+void Button::set_state(State state) noexcept
+{
+  if (state == State::focused && m_state != State::focused) {
+    m_hover.start(1.f, g_hover_fade_time.count(), g_ease_out);
+  } else if (state == State::idle && m_state != State::idle) {
+    m_hover.start(0.f, g_hover_fade_time.count(), g_ease_out);
+  }
+  m_state = state;
+}
+
 void Button::set_default_appearance(DrawableBox appearance) noexcept
 {
   m_default_appearance = appearance;
@@ -247,13 +352,14 @@ void Button::set_hover_appearance(DrawableBox appearance) noexcept
 }
 
 
-ScoreCounter::ScoreCounter(uint16_t n_max_digits)
+ScoreCounter::ScoreCounter(ReelBank& bank, uint16_t n_max_digits)
   : m_ndigits(n_max_digits)
 {
-  m_reels.resize(m_ndigits);
+  m_reels.reserve(m_ndigits);
+  for (uint16_t i = 0; i < m_ndigits; ++i) {
+    m_reels.emplace_back(bank, 10, 1);
+  }
   for (Reel& r : m_reels) {
-    r.resize(10);
-    r.set_n_lines(1);
     r.get_motion().set_min_speed(0.f);
 
     for (uint16_t i = 0; i < 10; ++i) {
@@ -282,42 +388,66 @@ void ScoreCounter::set_score(uint32_t score)
     score /= 10;
 
     Reel& r = m_reels[m_ndigits - 1 - i]; // From right to left
-    r.get_motion().stop_in(static_cast<float>(cur_digit),
-                           g_result_show_time.count());
+    // Rest position is exact, unchanged digits don't animate
+    const float digit_pos = static_cast<float>(cur_digit);
+    if (r.get_motion().is_at_rest() &&
+        r.get_motion().get_position() == digit_pos) {
+      continue;
+    }
+    r.get_motion().stop_in(digit_pos, g_result_show_time.count());
   }
 }
 
-void ScoreCounter::update(float dt)
+void ScoreCounter::bake_blur_strips(GraphicsSystem& gs, TextureCollection& tc)
 {
+  // All digit reels look the same
+  TextureId strip = tc.add(
+    m_reels[0].bake_blur_strip(gs, tc, g_blur_card_size, g_blur_card_size),
+    "score_blur_strip");
   for (Reel& r : m_reels) {
-    r.get_motion().advance(dt);
+    r.set_blur_texture(strip);
   }
 }
 
 void ScoreCounter::draw(DrawQueue& queue, Box<int> bounds) const
 {
-  FramedBox<int> frame = FramedBox<int>::create_inside(bounds, FrameSize{ 3 });
-  FramedGrid digit_row = FramedGrid::centered_in(frame, 1, m_ndigits);
+  if (m_digit_boxes.empty() || bounds != m_layout_bounds) {
+    FramedBox<int> frame =
+      FramedBox<int>::create_inside(bounds, FrameSize{ 3 });
+    FramedGrid digit_row = FramedGrid::centered_in(frame, 1, m_ndigits);
+    m_digit_boxes.resize(m_ndigits);
+    for (uint32_t i = 0; i < m_ndigits; ++i) {
+      m_digit_boxes[i] = digit_row.get_cell_box(0, i);
+    }
+    m_digit_frame = digit_row.get_framed_box();
+    m_layout_bounds = bounds;
+  }
+
   for (uint32_t i = 0; i < m_ndigits; ++i) {
-    m_reels[i].draw(queue, digit_row.get_cell_box(0, i));
+    m_reels[i].draw(queue, m_digit_boxes[i]);
   }
-  queue.add_colored_frame(digit_row.get_framed_box(), g_main_panel_color);
+  queue.add_colored_frame(m_digit_frame, g_main_panel_color);
 }
 
 
-SlotMachine::SlotMachine(TextureCollection& tc)
-  : m_score_counter(6)
+SlotMachine::SlotMachine(TextureCollection& tc,
+                         ReelBank& bank,
+                         AnimationBank& anims)
+  : m_start_btn(anims)
+  , m_stop_btn(anims)
+  , m_score_counter(bank, 6)
 {
   // App background
   m_texture = tc.get_id("background");
 
   // Configuring reels apearance
-  m_reels.resize(g_nreels);
+  m_reels.reserve(g_nreels);
+  for (uint32_t i = 0; i < g_nreels; ++i) {
+    m_reels.emplace_back(bank, g_nsymbols, g_nlines);
+  }
   float reel_visible_len = static_cast<float>(g_nlines);
 
   for (Reel& r : m_reels) {
-    r.resize(g_nsymbols);
-    r.set_n_lines(g_nlines);
     r.get_motion().set_min_speed(reel_visible_len * g_reel_min_speed);
     r.get_motion().set_max_speed(reel_visible_len * g_reel_max_speed);
 
@@ -366,16 +496,45 @@ SlotMachine::SlotMachine(TextureCollection& tc)
   m_score_counter.set_texture_set(tc.get_digits());
 }
 
-void SlotMachine::update(float dt)
+void SlotMachine::bake_blur_strips(GraphicsSystem& gs, TextureCollection& tc)
 {
+  // All reels have the same symbols order
+  TextureId strip = tc.add(
+    m_reels[0].bake_blur_strip(gs, tc, g_blur_card_size, g_blur_card_size),
+    "reel_blur_strip");
   for (Reel& r : m_reels) {
-    r.get_motion().advance(dt);
+    r.set_blur_texture(strip);
   }
-  m_score_counter.update(dt);
+  m_score_counter.bake_blur_strips(gs, tc);
 }
 
 void SlotMachine::draw(DrawQueue& queue, Box<int> bounds) const
 {
+  if (m_layout.reels.empty() || bounds != m_layout.bounds) {
+    update_layout(bounds);
+  }
+  const Layout& l = m_layout;
+
+  m_score_counter.draw(queue, l.score);
+  queue.add_colored_box(l.vert_space, g_main_panel_color);
+
+  for (uint16_t i = 0; i < m_reels.size(); ++i) {
+    m_reels[i].draw(queue, l.reels[i]);
+  }
+  queue.add_colored_frame(l.display_frame, g_main_panel_color);
+
+  queue.add_colored_box(l.control_panel, g_control_panel_color);
+  m_start_btn.draw(queue, l.start_btn);
+  m_stop_btn.draw(queue, l.stop_btn);
+
+  // Drawing background
+  queue.add_textured_frame(l.background, m_texture);
+}
+
+void SlotMachine::update_layout(Box<int> bounds) const
+{
+  m_layout.bounds = bounds;
+
   Box<float> f_bounds = bounds.cast_to<float>();
   int padding = iround(std::min(f_bounds.w, f_bounds.h) * 1.f / 20.f);
   float f_padding = static_cast<float>(padding);
@@ -400,34 +559,32 @@ void SlotMachine::draw(DrawQueue& queue, Box<int> bounds) const
                          pad_bounds.y,
                          iround(f_pad_bounds.w * hor_display_part),
                          iround(f_pad_bounds.h * score_counter_part) };
-  m_score_counter.draw(queue, score_bounds);
+  m_layout.score = score_bounds;
 
   Box<int> vert_space_box{ pad_bounds.x,
                            score_bounds.y + score_bounds.h,
                            score_bounds.w,
                            iround(f_pad_bounds.h * vert_space) };
-  queue.add_colored_box(vert_space_box, g_main_panel_color);
+  m_layout.vert_space = vert_space_box;
 
   Box<int> display_bounds{ pad_bounds.x,
                            vert_space_box.y + vert_space_box.h,
                            score_bounds.w,
                            iround(f_pad_bounds.h * vert_display_part) };
-  draw_display(queue, display_bounds);
+  layout_display(display_bounds);
 
   Box<int> control_panel_bounds{ pad_bounds.x +
                                    iround(hor_display_part * f_pad_bounds.w),
                                  pad_bounds.y,
                                  iround(f_pad_bounds.w * control_panel_part),
                                  pad_bounds.h };
-  draw_control_panel(queue, control_panel_bounds);
+  layout_control_panel(control_panel_bounds);
 
-  // Drawing background
-  FramedBox<int> i_frame =
+  m_layout.background =
     FramedBox<int>::create_inside(bounds, FrameSize{ padding });
-  queue.add_textured_frame(i_frame, m_texture);
 }
 
-void SlotMachine::draw_display(DrawQueue& queue, Box<int> bounds) const
+void SlotMachine::layout_display(Box<int> bounds) const
 {
   const uint16_t n_lines = m_reels[0].get_n_lines();
   const uint16_t n_reels = m_reels.size();
@@ -444,7 +601,6 @@ void SlotMachine::draw_display(DrawQueue& queue, Box<int> bounds) const
 
   FramedBox<int> frame = FramedBox<int>::create_inside(bounds, sum_frame);
   FramedGrid display_grid = FramedGrid::centered_in(frame, n_lines, n_reels);
-  frame = display_grid.get_framed_box();
   int px_reel_width = display_grid.cell_w;
   int px_reel_height = display_grid.cell_h * n_lines;
 
@@ -454,49 +610,75 @@ void SlotMachine::draw_display(DrawQueue& queue, Box<int> bounds) const
   reel_bounds.w = px_reel_width;
   reel_bounds.h = px_reel_height;
 
+  m_layout.reels.resize(n_reels);
   for (uint16_t i = 0; i < n_reels; ++i) {
     reel_bounds.x = display_grid.x + px_reel_width * i;
-    m_reels[i].draw(queue, reel_bounds);
+    m_layout.reels[i] = reel_bounds;
   }
-  queue.add_colored_frame(display_grid.get_framed_box(), g_main_panel_color);
+  m_layout.display_frame = display_grid.get_framed_box();
 }
 
-void SlotMachine::draw_control_panel(DrawQueue& queue, Box<int> bounds) const
+void SlotMachine::layout_control_panel(Box<int> bounds) const
 {
   const float f_width = static_cast<float>(bounds.w);
   const float f_height = static_cast<float>(bounds.h);
 
-  queue.add_colored_box(bounds, g_control_panel_color);
+  m_layout.control_panel = bounds;
 
   Box<int> start_btn_box = bounds;
   start_btn_box.x += iround(f_width * 1.f / 5.f);
   start_btn_box.y += iround(f_height * 7.f / 10.f);
   start_btn_box.w = iround(f_width * 2.f / 3.f);
   start_btn_box.h = iround(f_height * 1.f / 5.f);
-  m_start_btn.draw(queue, start_btn_box);
+  m_layout.start_btn = start_btn_box;
 
   Box<int> stop_btn_box = start_btn_box;
   stop_btn_box.y = bounds.y + iround(f_height * 1.f / 10.f);
-  m_stop_btn.draw(queue, stop_btn_box);
+  m_layout.stop_btn = stop_btn_box;
 }
 
 
 Scene::Scene(TextureCollection& tc)
   : m_tc(tc)
-  , m_slot_machine(tc)
+  , m_reel_bank()
+  , m_animations()
+  , m_slot_machine(tc, m_reel_bank, m_animations)
 {
 }
 
 void Scene::update(float dt)
 {
-  m_slot_machine.update(dt);
+  if (is_animating()) {
+    m_changed = true;
+  }
+  m_reel_bank.advance(dt);
+  m_animations.advance(dt);
+}
+
+void Scene::bake_blur_strips(GraphicsSystem& gs)
+{
+  m_slot_machine.bake_blur_strips(gs, m_tc);
 }
 
-DrawQueue Scene::build(uint16_t wnd_width, uint16_t wnd_height) const
+void Scene::interpolate(float alpha)
+{
+  if (!m_reel_bank.is_at_rest()) {
+    m_changed = true;
+  }
+  m_reel_bank.interpolate(alpha);
+}
+
+void Scene::build(DrawQueue& q, uint16_t wnd_width, uint16_t wnd_height) const
 {
-  DrawQueue q(m_tc, 128);
   Box<int> wnd_box = { 0, 0, wnd_width, wnd_height };
+  if (!m_changed && m_cache.is_valid(wnd_box)) {
+    m_cache.replay(q);
+    return;
+  }
+
+  const uint32_t mark = q.size();
   m_slot_machine.draw(q, wnd_box);
-  // SDL_Log("%td primitives to draw this frame", q.end() - q.begin());
-  return q;
+  m_cache.record(q, mark, wnd_box);
+  m_changed = false;
+  // SDL_Log("%u of %u primitives to draw this frame", q.size(), q.capacity());
 }
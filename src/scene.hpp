@@ -4,6 +4,7 @@
 #define SLOT_MACHINE_SCENE
 
 #include "animation.hpp"
+#include "easing.hpp"
 #include "primitives.hpp"
 #include "texture.hpp"
 
@@ -11,6 +12,8 @@
 #include <cstdint>
 #include <functional>
 
+class GraphicsSystem;
+
 class Drawable
 {
 public:
@@ -27,6 +30,7 @@ public:
   void draw(DrawQueue& queue, Box<int> bounds) const override;
   // Doesn't support textured frames
   void draw_clipped(DrawQueue& queue, Box<int> bounds, Box<int> visible) const;
+  SDL_Color get_cover_color() const noexcept { return m_cover_color; }
   void set_cover_color(SDL_Color color) noexcept { m_cover_color = color; }
   void set_cover_texture(TextureId texture_id) noexcept
   {
@@ -57,19 +61,48 @@ class Reel : public Drawable
 {
 public:
   // TODO fix: 0 cards break motion calculations
-  Reel(uint16_t n_cards = 1, uint16_t n_lines_visible = 1) noexcept;
-  DrawableBox& get_card(uint16_t i) { return m_cards[i]; }
+  Reel(ReelBank& bank, uint16_t n_cards = 1, uint16_t n_lines_visible = 1);
+  // Card may be modified, so cached commands are dropped
+  DrawableBox& get_card(uint16_t i)
+  {
+    m_cache.invalidate();
+    return m_cards[i];
+  }
   ReelMotion& get_motion() noexcept { return m_motion_state; }
   uint16_t get_n_lines() const noexcept { return m_nlines; }
-  void set_n_lines(uint16_t n_lines) noexcept { m_nlines = n_lines; }
+  void set_n_lines(uint16_t n_lines) noexcept
+  {
+    m_nlines = n_lines;
+    m_cache.invalidate();
+  }
   void resize(uint16_t n_cards);
+  // Cards stacked in rotation order and blurred along motion. Last visible
+  // cards are repeated on top, so any display window is contiguous
+  Texture bake_blur_strip(GraphicsSystem& gs,
+                          TextureCollection& tc,
+                          uint16_t card_width,
+                          uint16_t card_height) const;
+  // Used instead of cards while reel is fast
+  void set_blur_texture(TextureId texture_id) noexcept
+  {
+    m_blur_texture = texture_id;
+    m_cache.invalidate();
+  }
 
+  // Reel at rest repeats cached commands
   void draw(DrawQueue& queue, Box<int> bounds) const override;
 
 private:
+  bool is_blurred() const noexcept;
+  void draw_cards(DrawQueue& queue, Box<int> bounds) const;
+
   std::vector<DrawableBox> m_cards;
   ReelMotion m_motion_state;
   uint16_t m_nlines;
+  TextureId m_blur_texture{ NULL_TEXTURE };
+  mutable DrawCache m_cache;
+  mutable float m_cached_pos{ 0.f };
+  mutable bool m_cached_blurred{ false };
 };
 
 
@@ -85,57 +118,78 @@ public:
     number
   };
 
-  Button(std::function<void(const SDL_Event&)> event_handler = {});
+  Button(AnimationBank& bank,
+         std::function<void(const SDL_Event&)> event_handler = {});
   void draw(DrawQueue& queue, Box<int> bounds) const override;
   void set_event_handler(std::function<void(const SDL_Event&)> handler);
   void handle_event(const SDL_Event& e);
-  void set_enbaled(bool f_enabled) noexcept
-  {
-    m_state = f_enabled ? State::idle : State::disabled;
-  }
+  void set_enbaled(bool f_enabled) noexcept;
   void set_default_appearance(DrawableBox appearance) noexcept;
   void set_disabled_appearance(DrawableBox apperance) noexcept;
   void set_hover_appearance(DrawableBox appearance) noexcept;
 
 private:
+  // Starts hover fade on focus change
+  void set_state(State state) noexcept;
+
   mutable Box<int> m_hitbox; // updated in draw method
   std::function<void(const SDL_Event&)> m_handler;
   DrawableBox m_default_appearance;
   DrawableBox m_hover_appearance;
   DrawableBox m_disabled_apperance;
   State m_state{ State::idle };
+  Animation m_hover; // 0 default appearance, 1 hover appearance
 };
 
 
 class ScoreCounter : Drawable
 {
 public:
-  ScoreCounter(uint16_t n_max_digits);
+  ScoreCounter(ReelBank& bank, uint16_t n_max_digits);
   void set_texture_set(const std::array<TextureId, 10>& digit_textures);
   void set_score(uint32_t score);
-  void update(float dt);
+  void bake_blur_strips(GraphicsSystem& gs, TextureCollection& tc);
   void draw(DrawQueue& queue, Box<int> bounds) const override;
 
 private:
   uint16_t m_ndigits;
   std::vector<Reel> m_reels;
+  // Layout of last bounds
+  mutable Box<int> m_layout_bounds{ 0, 0, 0, 0 };
+  mutable std::vector<Box<int>> m_digit_boxes;
+  mutable FramedBox<int> m_digit_frame;
 };
 
 
 class SlotMachine : public Drawable
 {
 public:
-  SlotMachine(TextureCollection& tc);
+  SlotMachine(TextureCollection& tc, ReelBank& bank, AnimationBank& anims);
   std::vector<Reel>& get_reels() noexcept { return m_reels; }
   Button& get_start_btn() noexcept { return m_start_btn; }
   Button& get_stop_btn() noexcept { return m_stop_btn; }
   ScoreCounter& get_score_counter() noexcept { return m_score_counter; }
-  void update(float dt);
+  void bake_blur_strips(GraphicsSystem& gs, TextureCollection& tc);
   void draw(DrawQueue& queue, Box<int> bounds) const override;
 
 private:
-  void draw_display(DrawQueue& queue, Box<int> bounds) const;
-  void draw_control_panel(DrawQueue& queue, Box<int> bounds) const;
+  // Boxes of all parts, recomputed only when bounds change
+  struct Layout
+  {
+    Box<int> bounds{ 0, 0, 0, 0 }; // layout is computed for
+    Box<int> score;
+    Box<int> vert_space;
+    std::vector<Box<int>> reels;
+    FramedBox<int> display_frame;
+    Box<int> control_panel;
+    Box<int> start_btn;
+    Box<int> stop_btn;
+    FramedBox<int> background;
+  };
+
+  void update_layout(Box<int> bounds) const;
+  void layout_display(Box<int> bounds) const;
+  void layout_control_panel(Box<int> bounds) const;
   void set_texture(TextureId tx_id) noexcept;
 
   std::vector<Reel> m_reels;
@@ -143,6 +197,7 @@ private:
   Button m_stop_btn;
   ScoreCounter m_score_counter;
   TextureId m_texture{ NULL_TEXTURE };
+  mutable Layout m_layout;
 };
 
 
@@ -151,11 +206,29 @@ class Scene
 public:
   Scene(TextureCollection& tc);
   void update(float dt);
-  DrawQueue build(uint16_t wnd_width, uint16_t wnd_height) const;
+  // Between last two updates, alpha in [0, 1]
+  void interpolate(float alpha);
+  bool is_animating() const noexcept
+  {
+    return !m_reel_bank.is_at_rest() || m_animations.is_running();
+  }
+  // Needs renderer, so done after construction
+  void bake_blur_strips(GraphicsSystem& gs);
+  // Appends frame primitives to queue. Unchanged scene replays last frame
+  void build(DrawQueue& q, uint16_t wnd_width, uint16_t wnd_height) const;
+  // Next build has to walk the scene. Called on state changes outside of
+  // update, e.g. input or game events
+  void invalidate() noexcept { m_changed = true; }
+  bool has_changed() const noexcept { return m_changed; }
   SlotMachine& get_machine() noexcept { return m_slot_machine; }
+  AnimationBank& get_animations() noexcept { return m_animations; }
 
 private:
   TextureCollection& m_tc;
+  ReelBank m_reel_bank; // motion of all scene reels
+  AnimationBank m_animations; // UI elements
   SlotMachine m_slot_machine;
+  mutable DrawCache m_cache; // last built frame
+  mutable bool m_changed{ true };
 };
 #endif
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+// Monte Carlo spins of the current paytable with constant memory statistics
+#include "combination.hpp"
+#include "configuration.hpp"
+#include "paytable.hpp"
+#include "paytable_evaluator.hpp"
+#include "statistics.hpp"
+#include "symbol.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+// Sample mean may differ from exact one by this many standard errors
+constexpr double g_mean_tolerance = 5.;
+
+SpinStatistics simulate(uint64_t n_spins,
+                        uint32_t session_length,
+                        uint32_t seed)
+{
+  std::mt19937 rng(seed);
+  const auto& weights = g_default_paytable.reel_weights;
+  auto symbol_dist =
+    std::discrete_distribution<uint32_t>(weights.begin(), weights.end());
+
+  constexpr uint64_t batch_size = 4096;
+  std::vector<Combination::SymbolRow> rows(batch_size);
+  ResultBuffer results;
+  results.reserve(batch_size);
+
+  SpinStatistics stats(session_length);
+  for (uint64_t done = 0; done < n_spins; done += batch_size) {
+    size_t n_rows = std::min(batch_size, n_spins - done);
+    for (size_t i = 0; i < n_rows; ++i) {
+      for (Symbol& s : rows[i]) {
+        s = static_cast<Symbol>(symbol_dist(rng));
+      }
+    }
+
+    results.clear();
+    Combination::evaluate(rows.data(), n_rows, results);
+    stats.add(results);
+  }
+  return stats;
+}
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2) {
+    std::printf("Usage: %s <spins> [session length]\n", argv[0]);
+    return 1;
+  }
+  uint64_t n_spins = std::strtoull(argv[1], nullptr, 10);
+  uint32_t session_length =
+    argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 100;
+  if (n_spins == 0 || session_length == 0) {
+    std::printf("Spins and session length must be positive\n");
+    return 1;
+  }
+
+  // Every thread owns its statistics, merged after join
+  uint32_t n_threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<SpinStatistics> results(n_threads,
+                                      SpinStatistics(session_length));
+  std::vector<std::thread> threads;
+  std::random_device rd;
+  for (uint32_t i = 0; i < n_threads; ++i) {
+    uint64_t thread_spins =
+      n_spins / n_threads + (i < n_spins % n_threads ? 1 : 0);
+    uint32_t seed = rd();
+    threads.emplace_back([&results, i, thread_spins, session_length, seed]() {
+      results[i] = simulate(thread_spins, session_length, seed);
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+
+  SpinStatistics total(session_length);
+  for (const SpinStatistics& s : results) {
+    total.merge(s);
+  }
+
+  const RunningMoments& spins = total.get_spin_points();
+  std::printf("Spins: %llu, free spins: %llu\n",
+              static_cast<unsigned long long>(total.get_n_spins()),
+              static_cast<unsigned long long>(total.get_n_free_spins()));
+  std::printf("Points per spin: mean %.4f, deviation %.4f\n",
+              spins.get_mean(),
+              std::sqrt(spins.get_variance()));
+
+  std::printf("\nPoints  spins\n");
+  for (const auto& [points, count] : total.get_points_counts()) {
+    std::printf("%-7u %llu\n", points, static_cast<unsigned long long>(count));
+  }
+
+  const RunningMoments& sessions = total.get_session_payouts();
+  const QuantileSketch& quantiles = total.get_session_quantiles();
+  std::printf("\nSessions of %u spins: %llu, mean %.2f, deviation %.2f\n",
+              session_length,
+              static_cast<unsigned long long>(sessions.get_count()),
+              sessions.get_mean(),
+              std::sqrt(sessions.get_variance()));
+  for (double q : { 0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99 }) {
+    std::printf(
+      "  %4.0f%% quantile: %.0f\n", q * 100., quantiles.get_quantile(q));
+  }
+
+  // Compare with exact expectation over all symbol rows
+  uint32_t max_points = g_default_paytable.get_max_points();
+  uint32_t max_sampled = total.get_points_counts().rbegin()->first;
+  PaytableEvaluator::Score exact =
+    PaytableEvaluator().evaluate(g_default_paytable, 1);
+  double mean_error = std::abs(spins.get_mean() - exact.mean);
+  double standard_error =
+    exact.volatility / std::sqrt(static_cast<double>(total.get_n_spins()));
+  std::printf("\nExact points per spin: mean %.4f, deviation %.4f\n",
+              exact.mean,
+              exact.volatility);
+  std::printf("Sample mean error: %.4f, %.2f standard errors\n",
+              mean_error,
+              mean_error / standard_error);
+
+  if (max_sampled > max_points) {
+    std::printf("Error: sampled %u points, paytable maximum is %u\n",
+                max_sampled,
+                max_points);
+    return 1;
+  }
+  if (mean_error > g_mean_tolerance * standard_error) {
+    std::printf("Error: sample mean is outside %.0f standard errors of "
+                "exact mean\n",
+                g_mean_tolerance);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#include "statistics.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+void RunningMoments::add(double value) noexcept
+{
+  m_count += 1;
+  double delta = value - m_mean;
+  m_mean += delta / static_cast<double>(m_count);
+  m_m2 += delta * (value - m_mean);
+}
+
+void RunningMoments::merge(const RunningMoments& other) noexcept
+{
+  if (other.m_count == 0) {
+    return;
+  }
+  double n_a = static_cast<double>(m_count);
+  double n_b = static_cast<double>(other.m_count);
+  double n = n_a + n_b;
+  double delta = other.m_mean - m_mean;
+
+  m_mean += delta * n_b / n;
+  m_m2 += other.m_m2 + delta * delta * n_a * n_b / n;
+  m_count += other.m_count;
+}
+
+double RunningMoments::get_variance() const noexcept
+{
+  return m_count > 1 ? m_m2 / static_cast<double>(m_count - 1) : 0.;
+}
+
+
+QuantileSketch::QuantileSketch(double relative_accuracy)
+  : m_gamma((1. + relative_accuracy) / (1. - relative_accuracy))
+  , m_log_gamma(std::log(m_gamma))
+{
+  assert(relative_accuracy > 0. && relative_accuracy < 1.);
+}
+
+int32_t QuantileSketch::get_bucket_index(double value) const noexcept
+{
+  return static_cast<int32_t>(std::ceil(std::log(value) / m_log_gamma));
+}
+
+double QuantileSketch::get_bucket_value(int32_t index) const noexcept
+{
+  // Middle of (gamma^(i-1), gamma^i] range in terms of relative error
+  return 2. * std::pow(m_gamma, index) / (m_gamma + 1.);
+}
+
+void QuantileSketch::add(double value)
+{
+  assert(value >= 0.);
+  m_count += 1;
+  if (value == 0.) {
+    m_zero_count += 1;
+  } else {
+    m_buckets[get_bucket_index(value)] += 1;
+  }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+  assert(m_gamma == other.m_gamma);
+  m_count += other.m_count;
+  m_zero_count += other.m_zero_count;
+  for (const auto& [index, count] : other.m_buckets) {
+    m_buckets[index] += count;
+  }
+}
+
+double QuantileSketch::get_quantile(double q) const
+{
+  assert(q >= 0. && q <= 1.);
+  if (m_count == 0) {
+    return 0.;
+  }
+  uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(m_count - 1));
+  if (rank < m_zero_count) {
+    return 0.;
+  }
+  uint64_t passed = m_zero_count;
+  for (const auto& [index, count] : m_buckets) {
+    passed += count;
+    if (rank < passed) {
+      return get_bucket_value(index);
+    }
+  }
+  return get_bucket_value(m_buckets.rbegin()->first);
+}
+
+
+SpinStatistics::SpinStatistics(uint32_t session_length)
+  : m_session_length(session_length)
+{
+  assert(session_length > 0);
+}
+
+void SpinStatistics::add(uint32_t points, bool free_spin)
+{
+  m_points_counts[points] += 1;
+  m_spin_points.add(static_cast<double>(points));
+  if (free_spin) {
+    m_n_free_spins += 1;
+  }
+
+  m_session_sum += points;
+  m_session_spins += 1;
+  if (m_session_spins == m_session_length) {
+    double payout = static_cast<double>(m_session_sum);
+    m_session_payouts.add(payout);
+    m_session_quantiles.add(payout);
+    m_session_sum = 0;
+    m_session_spins = 0;
+  }
+}
+
+void SpinStatistics::add(const ResultBuffer& results)
+{
+  const std::vector<uint32_t>& points = results.get_points();
+  const std::vector<uint8_t>& flags = results.get_flags();
+  constexpr uint8_t free_spin_flag = ResultBuffer::PackedResult::free_spin_flag;
+  for (size_t i = 0; i < points.size(); ++i) {
+    add(points[i], (flags[i] & free_spin_flag) != 0);
+  }
+}
+
+void SpinStatistics::merge(const SpinStatistics& other)
+{
+  assert(m_session_length == other.m_session_length);
+  for (const auto& [points, count] : other.m_points_counts) {
+    m_points_counts[points] += count;
+  }
+  m_n_free_spins += other.m_n_free_spins;
+  m_spin_points.merge(other.m_spin_points);
+  m_session_payouts.merge(other.m_session_payouts);
+  m_session_quantiles.merge(other.m_session_quantiles);
+}
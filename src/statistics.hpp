@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#ifndef SLOT_MACHINE_STATISTICS
+#define SLOT_MACHINE_STATISTICS
+
+#include "combination.hpp"
+
+#include <cstdint>
+#include <map>
+
+// Welford's running mean and variance
+class RunningMoments
+{
+public:
+  void add(double value) noexcept;
+  // Chan's parallel combination
+  void merge(const RunningMoments& other) noexcept;
+  uint64_t get_count() const noexcept { return m_count; }
+  double get_mean() const noexcept { return m_mean; }
+  double get_variance() const noexcept;
+
+private:
+  uint64_t m_count{ 0 };
+  double m_mean{ 0. };
+  double m_m2{ 0. }; // sum of squared deviations from mean
+};
+
+
+// Quantiles of non-negative values with bounded relative error.
+// Values are counted in logarithmic buckets (DDSketch)
+class QuantileSketch
+{
+public:
+  QuantileSketch(double relative_accuracy = 0.01);
+  void add(double value);
+  // Sketches must have equal accuracy
+  void merge(const QuantileSketch& other);
+  uint64_t get_count() const noexcept { return m_count; }
+  double get_quantile(double q) const;
+
+private:
+  int32_t get_bucket_index(double value) const noexcept;
+  double get_bucket_value(int32_t index) const noexcept;
+
+  double m_gamma;
+  double m_log_gamma;
+  uint64_t m_count{ 0 };
+  uint64_t m_zero_count{ 0 };
+  std::map<int32_t, uint64_t> m_buckets;
+};
+
+
+// Constant memory summary of any number of spins. Each thread fills own
+// instance, results are merged after threads finish
+class SpinStatistics
+{
+public:
+  SpinStatistics(uint32_t session_length = 100);
+  void add(uint32_t points, bool free_spin);
+  // All results of buffer in order
+  void add(const ResultBuffer& results);
+  // Unfinished session of other is dropped
+  void merge(const SpinStatistics& other);
+
+  uint64_t get_n_spins() const noexcept { return m_spin_points.get_count(); }
+  uint64_t get_n_free_spins() const noexcept { return m_n_free_spins; }
+  uint32_t get_session_length() const noexcept { return m_session_length; }
+  // Exact number of spins for every points value
+  const std::map<uint32_t, uint64_t>& get_points_counts() const noexcept
+  {
+    return m_points_counts;
+  }
+  const RunningMoments& get_spin_points() const noexcept
+  {
+    return m_spin_points;
+  }
+  const RunningMoments& get_session_payouts() const noexcept
+  {
+    return m_session_payouts;
+  }
+  const QuantileSketch& get_session_quantiles() const noexcept
+  {
+    return m_session_quantiles;
+  }
+
+private:
+  uint32_t m_session_length;
+  uint32_t m_session_spins{ 0 };
+  uint64_t m_session_sum{ 0 };
+  uint64_t m_n_free_spins{ 0 };
+  std::map<uint32_t, uint64_t> m_points_counts;
+  RunningMoments m_spin_points;
+  RunningMoments m_session_payouts;
+  QuantileSketch m_session_quantiles;
+};
+#endif
@@ -3,9 +3,11 @@
 #ifndef SLOT_MACHINE_SYMBOL
 #define SLOT_MACHINE_SYMBOL
 
+#include <array>
+#include <cassert>
 #include <cstdint>
 
-enum class SymbolFamily : uint32_t
+enum class SymbolFamily : uint8_t
 {
   special = 0,
   fruit,
@@ -13,7 +15,7 @@ enum class SymbolFamily : uint32_t
   jewel,
   number
 };
-enum class Symbol : uint32_t
+enum class Symbol : uint8_t
 {
   lucky_seven = 0, // Biggest base value, doesn't combine with others
   cross,           // Breaks adjacent combos
@@ -37,72 +39,63 @@ constexpr uint32_t g_nsymbols = static_cast<uint32_t>(Symbol::number);
 constexpr uint32_t g_nfamilies = static_cast<uint32_t>(SymbolFamily::number);
 constexpr uint32_t g_nsy_family = g_nsymbols / g_nfamilies;
 
-constexpr const char* get_symbol_name(Symbol s)
+struct SymbolDescriptor
 {
-  switch (s) {
-    case Symbol::lucky_seven:
-      return "seven";
-    case Symbol::respin:
-      return "respin";
-    case Symbol::question:
-      return "question";
-    case Symbol::cross:
-      return "cross";
-    case Symbol::apple:
-      return "apple";
-    case Symbol::carrot:
-      return "carrot";
-    case Symbol::corn:
-      return "corn";
-    case Symbol::grape:
-      return "grape";
-    case Symbol::spade:
-      return "spade";
-    case Symbol::club:
-      return "club";
-    case Symbol::heart:
-      return "heart";
-    case Symbol::diamond:
-      return "diamond";
-    case Symbol::amethyst:
-      return "amethyst";
-    case Symbol::emerald:
-      return "emerald";
-    case Symbol::topaz:
-      return "topaz";
-    case Symbol::crystal:
-      return "crystal";
-    case Symbol::number:
-      return "";
+  Symbol symbol;
+  const char* name;
+  SymbolFamily family;
+  uint32_t base_value;
+  uint32_t reel_weight; // relative frequency of stops on the symbol
+  const char* file_name;
+};
+
+// Single source of symbol properties, indexed by Symbol value
+constexpr std::array<SymbolDescriptor, g_nsymbols> g_symbol_descriptors = { {
+  { Symbol::lucky_seven, "seven", SymbolFamily::special, 32, 1,
+    "lucky_seven.svg" },
+  { Symbol::cross, "cross", SymbolFamily::special, 12, 1, "cross.svg" },
+  { Symbol::respin, "respin", SymbolFamily::special, 12, 1, "respin.svg" },
+  { Symbol::question, "question", SymbolFamily::special, 12, 1, "question.svg" },
+  { Symbol::apple, "apple", SymbolFamily::fruit, 8, 1, "apple.svg" },
+  { Symbol::carrot, "carrot", SymbolFamily::fruit, 8, 1, "carrot.svg" },
+  { Symbol::corn, "corn", SymbolFamily::fruit, 8, 1, "corn.svg" },
+  { Symbol::grape, "grape", SymbolFamily::fruit, 8, 1, "grape.svg" },
+  { Symbol::spade, "spade", SymbolFamily::suit, 16, 1, "spade.svg" },
+  { Symbol::club, "club", SymbolFamily::suit, 16, 1, "club.svg" },
+  { Symbol::heart, "heart", SymbolFamily::suit, 16, 1, "heart.svg" },
+  { Symbol::diamond, "diamond", SymbolFamily::suit, 16, 1, "diamond.svg" },
+  { Symbol::amethyst, "amethyst", SymbolFamily::jewel, 24, 1, "amethyst.svg" },
+  { Symbol::emerald, "emerald", SymbolFamily::jewel, 24, 1, "emerald.svg" },
+  { Symbol::topaz, "topaz", SymbolFamily::jewel, 24, 1, "topaz.svg" },
+  { Symbol::crystal, "crystal", SymbolFamily::jewel, 24, 1, "crystal.svg" },
+} };
+
+constexpr bool symbol_descriptors_ordered() noexcept
+{
+  for (uint32_t i = 0; i < g_nsymbols; ++i) {
+    if (static_cast<uint32_t>(g_symbol_descriptors[i].symbol) != i) {
+      return false;
+    }
   }
+  return true;
+}
+static_assert(symbol_descriptors_ordered(),
+              "Symbol descriptors must follow Symbol enumeration order");
+
+constexpr const SymbolDescriptor& get_symbol_descriptor(Symbol s) noexcept
+{
+  assert(static_cast<uint8_t>(s) < g_nsymbols); // Symbol::number has none
+  return g_symbol_descriptors[static_cast<uint8_t>(s)];
+}
+
+constexpr const char* get_symbol_name(Symbol s) noexcept
+{
+  return get_symbol_descriptor(s).name;
 }
 
 constexpr SymbolFamily get_symbol_family(Symbol sy) noexcept
 {
-  switch (sy) {
-    case Symbol::lucky_seven:
-    case Symbol::respin:
-    case Symbol::question:
-    case Symbol::cross:
-      return SymbolFamily::special;
-    case Symbol::apple:
-    case Symbol::carrot:
-    case Symbol::corn:
-    case Symbol::grape:
-      return SymbolFamily::fruit;
-    case Symbol::spade:
-    case Symbol::club:
-    case Symbol::heart:
-    case Symbol::diamond:
-      return SymbolFamily::suit;
-    case Symbol::amethyst:
-    case Symbol::emerald:
-    case Symbol::topaz:
-    case Symbol::crystal:
-      return SymbolFamily::jewel;
-    case Symbol::number:
-      return SymbolFamily::number;
-  }
-};
+  return get_symbol_descriptor(sy).family;
+}
 
 #endif
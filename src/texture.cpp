@@ -1,12 +1,74 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 // Copyright © 2025 Mansur Mukhametzyanov
 #include "texture.hpp"
+#include "atlas.hpp"
+#include "configuration.hpp"
 #include "graphics_system.hpp"
 #include "utils.hpp"
 
 #include <SDL3/SDL_iostream.h>
 #include <SDL3_image/SDL_image.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <numeric>
 #include <utility>
+#include <vector>
+
+namespace {
+struct SurfaceDeleter
+{
+  void operator()(SDL_Surface* s) const noexcept { SDL_DestroySurface(s); }
+};
+using SurfacePtr = std::unique_ptr<SDL_Surface, SurfaceDeleter>;
+
+SurfacePtr rasterize_svg(const std::string& file_name,
+                         uint16_t width,
+                         uint16_t height)
+{
+  SDL_IOStream* svg_file = SDL_IOFromFile(file_name.c_str(), "rb");
+  if (svg_file == nullptr) {
+    throw SdlError("Failed to load image: %s", file_name.c_str());
+  }
+
+  SDL_Surface* surface = IMG_LoadSizedSVG_IO(svg_file, width, height);
+  SDL_CloseIO(svg_file);
+  if (!surface) {
+    throw SdlError("%s image is not valid SVG format", file_name.c_str());
+  }
+  return SurfacePtr(surface);
+}
+
+// Copies image to (x, y) of page and repeats its edge texels pad times
+// around it. Corners of padding stay transparent
+void blit_extruded(SDL_Surface* image,
+                   SDL_Surface* page,
+                   int x,
+                   int y,
+                   int pad)
+{
+  const int w = image->w;
+  const int h = image->h;
+  SDL_SetSurfaceBlendMode(image, SDL_BLENDMODE_NONE); // copy alpha as is
+  SDL_Rect dst{ x, y, w, h };
+  SDL_BlitSurface(image, nullptr, page, &dst);
+  for (int k = 1; k <= pad; ++k) {
+    SDL_Rect left{ 0, 0, 1, h };
+    SDL_Rect left_dst{ x - k, y, 1, h };
+    SDL_BlitSurface(image, &left, page, &left_dst);
+    SDL_Rect right{ w - 1, 0, 1, h };
+    SDL_Rect right_dst{ x + w - 1 + k, y, 1, h };
+    SDL_BlitSurface(image, &right, page, &right_dst);
+    SDL_Rect top{ 0, 0, w, 1 };
+    SDL_Rect top_dst{ x, y - k, w, 1 };
+    SDL_BlitSurface(image, &top, page, &top_dst);
+    SDL_Rect bottom{ 0, h - 1, w, 1 };
+    SDL_Rect bottom_dst{ x, y + h - 1 + k, w, 1 };
+    SDL_BlitSurface(image, &bottom, page, &bottom_dst);
+  }
+}
+}
 
 Texture Texture::from_surface(SDL_Surface* surface, GraphicsSystem& gs)
 {
@@ -27,20 +89,8 @@ Texture Texture::from_svg_file(std::string file_name,
                                uint16_t width,
                                uint16_t height)
 {
-  SDL_IOStream* svg_file = SDL_IOFromFile(file_name.c_str(), "rb");
-  if (svg_file == nullptr) {
-    throw SdlError("Failed to load image: %s", file_name.c_str());
-  }
-
-  SDL_Surface* surface = IMG_LoadSizedSVG_IO(svg_file, width, height);
-  SDL_CloseIO(svg_file);
-  if (!surface) {
-    throw SdlError("%s image is not valid SVG format", file_name.c_str());
-  }
-
-  Texture result = Texture::from_surface(surface, gs);
-  SDL_DestroySurface(surface);
-  return result;
+  SurfacePtr surface = rasterize_svg(file_name, width, height);
+  return Texture::from_surface(surface.get(), gs);
 }
 
 Texture::~Texture()
@@ -76,6 +126,7 @@ TextureCollection::TextureCollection(std::string images_directory,
   m_directory = images_directory + '/';
   if (reserved > 0) {
     m_textures.reserve(reserved);
+    m_regions.reserve(reserved);
     m_texture_ids.reserve(reserved);
   }
 }
@@ -85,6 +136,39 @@ void swap(Texture& lhs, Texture& rhs)
   lhs.swap(rhs);
 }
 
+void blur_vertically(SDL_Surface* surface, uint16_t radius)
+{
+  assert(surface->format == SDL_PIXELFORMAT_RGBA32);
+  const int w = surface->w;
+  const int h = surface->h;
+  const int window = 2 * radius + 1;
+  std::vector<uint8_t> column(static_cast<size_t>(h) * 4);
+
+  SDL_LockSurface(surface);
+  uint8_t* pixels = static_cast<uint8_t*>(surface->pixels);
+  for (int x = 0; x < w; ++x) {
+    for (int y = 0; y < h; ++y) {
+      std::memcpy(&column[y * 4], pixels + y * surface->pitch + x * 4, 4);
+    }
+    for (int c = 0; c < 4; ++c) {
+      // Running sum over the window centered at y
+      uint32_t sum = 0;
+      for (int k = -radius; k <= radius; ++k) {
+        sum += column[((k % h + h) % h) * 4 + c];
+      }
+      for (int y = 0; y < h; ++y) {
+        pixels[y * surface->pitch + x * 4 + c] =
+          static_cast<uint8_t>(sum / window);
+        const int out = ((y - radius) % h + h) % h;
+        const int in = (y + radius + 1) % h;
+        sum += column[in * 4 + c];
+        sum -= column[out * 4 + c];
+      }
+    }
+  }
+  SDL_UnlockSurface(surface);
+}
+
 
 void TextureCollection::load(std::string file_name,
                              std::string texture_name,
@@ -100,23 +184,107 @@ void TextureCollection::load(std::string file_name,
   }
 
   std::string file_path = m_directory + file_name;
-  m_textures.push_back(Texture::from_svg_file(file_path, gs, w, h));
-  m_texture_ids[texture_name] = m_textures.size(); // id = index + 1!
+  add(Texture::from_svg_file(file_path, gs, w, h), texture_name);
+}
+
+TextureId TextureCollection::add(Texture texture, std::string texture_name)
+{
+  if (auto it = m_texture_ids.find(texture_name); it != m_texture_ids.end()) {
+    throw ThreadException("'%s' name is not unique", texture_name.c_str());
+  }
+  TextureRegion whole{
+    texture.get_handler(), 0, 0, texture.get_width(), texture.get_height()
+  };
+  m_textures.push_back(std::move(texture));
+  return add_region(whole, std::move(texture_name));
+}
+
+TextureId TextureCollection::add_region(TextureRegion region,
+                                        std::string texture_name)
+{
+  if (auto it = m_texture_ids.find(texture_name); it != m_texture_ids.end()) {
+    throw ThreadException("'%s' name is not unique", texture_name.c_str());
+  }
+  m_regions.push_back(region);
+  TextureId id = m_regions.size(); // id = index + 1!
+  m_texture_ids[std::move(texture_name)] = id;
+  return id;
 }
 
 void TextureCollection::load_predefined(GraphicsSystem& gs)
 {
+  std::vector<AtlasImage> images;
   for (TextureResource res : big_resolution_textures) {
-    load(res.file_name, res.tx_name, gs, 1024, 1024);
+    images.push_back({ res.file_name, res.tx_name, 1024, 1024 });
   }
   for (TextureResource res : surrounding_textures) {
-    load(res.file_name, res.tx_name, gs);
+    images.push_back({ res.file_name, res.tx_name, 256, 256 });
   }
-  for (TextureResource res : symbol_textures) {
-    load(res.file_name, res.tx_name, gs);
+  for (const SymbolDescriptor& sd : g_symbol_descriptors) {
+    images.push_back({ sd.file_name, sd.name, 256, 256 });
   }
   for (TextureResource res : digit_textures) {
-    load(res.file_name, res.tx_name, gs);
+    images.push_back({ res.file_name, res.tx_name, 256, 256 });
+  }
+  load_atlas(images, gs);
+}
+
+void TextureCollection::load_atlas(const std::vector<AtlasImage>& images,
+                                   GraphicsSystem& gs)
+{
+  std::vector<SurfacePtr> surfaces;
+  surfaces.reserve(images.size());
+  for (const AtlasImage& image : images) {
+    if (m_texture_ids.find(image.tx_name) != m_texture_ids.end()) {
+      throw ThreadException("'%s' name is not unique", image.tx_name.c_str());
+    }
+    surfaces.push_back(rasterize_svg(
+      m_directory + image.file_name, image.width, image.height));
+  }
+
+  // Tallest first, skyline stays flatter
+  std::vector<uint32_t> order(images.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return surfaces[a]->h > surfaces[b]->h;
+  });
+
+  constexpr uint16_t pad = g_atlas_padding;
+  SkylinePacker packer(g_atlas_page_size);
+  std::vector<SkylinePacker::Placement> placements(images.size());
+  for (uint32_t i : order) {
+    placements[i] =
+      packer.place(surfaces[i]->w + 2 * pad, surfaces[i]->h + 2 * pad);
+  }
+
+  const uint32_t first_page = m_textures.size();
+  for (uint32_t page = 0; page < packer.get_npages(); ++page) {
+    SurfacePtr page_surface(SDL_CreateSurface(
+      g_atlas_page_size, g_atlas_page_size, SDL_PIXELFORMAT_RGBA32));
+    if (!page_surface) {
+      throw SdlError("Failed to create atlas page");
+    }
+    SDL_ClearSurface(page_surface.get(), 0.f, 0.f, 0.f, 0.f);
+    for (uint32_t i = 0; i < images.size(); ++i) {
+      if (placements[i].page == page) {
+        blit_extruded(surfaces[i].get(),
+                      page_surface.get(),
+                      placements[i].x + pad,
+                      placements[i].y + pad,
+                      pad);
+      }
+    }
+    m_textures.push_back(Texture::from_surface(page_surface.get(), gs));
+  }
+
+  for (uint32_t i = 0; i < images.size(); ++i) {
+    const SkylinePacker::Placement& pl = placements[i];
+    add_region({ m_textures[first_page + pl.page].get_handler(),
+                 static_cast<uint16_t>(pl.x + pad),
+                 static_cast<uint16_t>(pl.y + pad),
+                 static_cast<uint16_t>(surfaces[i]->w),
+                 static_cast<uint16_t>(surfaces[i]->h) },
+               images[i].tx_name);
   }
 }
 
@@ -129,10 +297,10 @@ TextureId TextureCollection::get_id(const std::string& texture_name) const
   }
 }
 
-Texture& TextureCollection::get_texture(TextureId id)
+const TextureRegion& TextureCollection::get_region(TextureId id) const
 {
-  assert(id <= m_textures.size());
-  return m_textures[id - 1];
+  assert(id != NULL_TEXTURE && id <= m_regions.size());
+  return m_regions[id - 1];
 }
 
 std::array<TextureId, 10> TextureCollection::get_digits() const
@@ -49,6 +49,20 @@ private:
 
 void swap(Texture& lhs, Texture& rhs);
 
+// Pixel rectangle of texture, whole texture unless packed into atlas
+struct TextureRegion
+{
+  SDL_Texture* handler{ nullptr };
+  uint16_t x{ 0 };
+  uint16_t y{ 0 };
+  uint16_t w{ 0 };
+  uint16_t h{ 0 };
+};
+
+// Box blur of RGBA32 surface along columns. Rows wrap around, so blurred
+// cyclic strip stays seamless
+void blur_vertically(SDL_Surface* surface, uint16_t radius);
+
 
 struct TextureResource
 {
@@ -57,6 +71,16 @@ struct TextureResource
 };
 
 
+// Image rasterized into atlas page
+struct AtlasImage
+{
+  std::string file_name;
+  std::string tx_name;
+  uint16_t width;
+  uint16_t height;
+};
+
+
 class TextureCollection
 {
 public:
@@ -66,9 +90,15 @@ public:
             GraphicsSystem& gs,
             uint16_t w = 256,
             uint16_t h = 256);
+  // Predefined images share few atlas pages, so frame switches textures
+  // rarely
   void load_predefined(GraphicsSystem& gs);
+  // Packs images into atlas pages of g_atlas_page_size
+  void load_atlas(const std::vector<AtlasImage>& images, GraphicsSystem& gs);
+  // Texture created at runtime
+  TextureId add(Texture texture, std::string texture_name);
   TextureId get_id(const std::string& texture_name) const;
-  Texture& get_texture(TextureId id);
+  const TextureRegion& get_region(TextureId id) const;
   std::array<TextureId, 10> get_digits() const;
 
 private:
@@ -89,28 +119,12 @@ private:
     TextureResource{ "6.svg", "6" }, TextureResource{ "7.svg", "7" },
     TextureResource{ "8.svg", "8" }, TextureResource{ "9.svg", "9" },
   };
-  static constexpr std::array symbol_textures = {
-    TextureResource{ "lucky_seven.svg", get_symbol_name(Symbol::lucky_seven) },
-    TextureResource{ "cross.svg", get_symbol_name(Symbol::cross) },
-    TextureResource{ "question.svg", get_symbol_name(Symbol::question) },
-    TextureResource{ "respin.svg", get_symbol_name(Symbol::respin) },
-    TextureResource{ "apple.svg", get_symbol_name(Symbol::apple) },
-    TextureResource{ "carrot.svg", get_symbol_name(Symbol::carrot) },
-    TextureResource{ "corn.svg", get_symbol_name(Symbol::corn) },
-    TextureResource{ "grape.svg", get_symbol_name(Symbol::grape) },
-    TextureResource{ "spade.svg", get_symbol_name(Symbol::spade) },
-    TextureResource{ "club.svg", get_symbol_name(Symbol::club) },
-    TextureResource{ "heart.svg", get_symbol_name(Symbol::heart) },
-    TextureResource{ "diamond.svg", get_symbol_name(Symbol::diamond) },
-    TextureResource{ "amethyst.svg", get_symbol_name(Symbol::amethyst) },
-    TextureResource{ "emerald.svg", get_symbol_name(Symbol::emerald) },
-    TextureResource{ "topaz.svg", get_symbol_name(Symbol::topaz) },
-    TextureResource{ "crystal.svg", get_symbol_name(Symbol::crystal) },
-  };
-  static_assert(symbol_textures.size() == g_nsymbols);
+
+  TextureId add_region(TextureRegion region, std::string texture_name);
 
   std::string m_directory;
-  std::vector<Texture> m_textures;
+  std::vector<Texture> m_textures; // atlas pages and standalone textures
+  std::vector<TextureRegion> m_regions;
   std::unordered_map<std::string, TextureId> m_texture_ids;
 };
 #endif
@@ -0,0 +1,25 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#include "timeline.hpp"
+
+#include <utility>
+
+void Timeline::schedule(TimePoint time, Handler handler)
+{
+  m_events.emplace(time, std::move(handler));
+}
+
+void Timeline::advance(TimePoint time)
+{
+  while (!m_events.empty() && m_events.begin()->first <= time) {
+    // Handler may schedule or clear events, so detach it first
+    Handler handler = std::move(m_events.begin()->second);
+    m_events.erase(m_events.begin());
+    handler();
+  }
+}
+
+TimePoint Timeline::get_next_time() const noexcept
+{
+  return m_events.empty() ? TimePoint::max() : m_events.begin()->first;
+}
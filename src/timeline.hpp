@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#ifndef SLOT_MACHINE_TIMELINE
+#define SLOT_MACHINE_TIMELINE
+
+#include "configuration.hpp"
+
+#include <functional>
+#include <map>
+
+// Events scheduled at absolute time points, kept in one sorted stream.
+// Only the earliest event is checked, so waiting costs nothing per event
+class Timeline
+{
+public:
+  using Handler = std::function<void()>;
+
+  // Events with equal time run in scheduling order
+  void schedule(TimePoint time, Handler handler);
+  // Runs all events due at time, including ones scheduled by handlers
+  void advance(TimePoint time);
+  void clear() noexcept { m_events.clear(); }
+  bool empty() const noexcept { return m_events.empty(); }
+  // TimePoint::max() if nothing is scheduled
+  TimePoint get_next_time() const noexcept;
+
+private:
+  std::multimap<TimePoint, Handler> m_events;
+};
+#endif
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+// Copyright © 2025 Mansur Mukhametzyanov
+#ifndef SLOT_MACHINE_TRIPLE_BUFFER
+#define SLOT_MACHINE_TRIPLE_BUFFER
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free handoff of latest value from one producer thread to one
+// consumer thread. Producer fills back slot and publishes it, consumer
+// takes latest published slot. Neither waits for the other, skipped
+// values are overwritten. Slots are reused, so they keep their capacity
+template<class T>
+class TripleBuffer
+{
+public:
+  // Producer side
+  T& get_back() noexcept { return m_slots[m_back]; }
+  // Back slot becomes latest one, previous latest is new back slot
+  void publish() noexcept
+  {
+    const uint8_t latest =
+      m_latest.exchange(m_back | fresh_bit, std::memory_order_acq_rel);
+    m_back = latest & index_mask;
+  }
+
+  // Consumer side. Takes latest slot if something was published since
+  // last call
+  bool fetch() noexcept
+  {
+    if ((m_latest.load(std::memory_order_relaxed) & fresh_bit) == 0) {
+      return false;
+    }
+    const uint8_t latest =
+      m_latest.exchange(m_front, std::memory_order_acq_rel);
+    m_front = latest & index_mask;
+    return true;
+  }
+  T& get_front() noexcept { return m_slots[m_front]; }
+
+private:
+  static constexpr uint8_t index_mask = 0x3;
+  static constexpr uint8_t fresh_bit = 0x4;
+
+  std::array<T, 3> m_slots;
+  std::atomic<uint8_t> m_latest{ 1 }; // slot index and fresh bit
+  uint8_t m_back{ 0 };                // owned by producer
+  uint8_t m_front{ 2 };               // owned by consumer
+};
+#endif